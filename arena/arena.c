@@ -0,0 +1,87 @@
+//  Partie implantation du module arena.
+
+#include "arena.h"
+#include <stddef.h>
+#include <stdint.h>
+
+//  La taille du premier bloc vaut ARENA__CHUNK_MIN octets. Elle double à chaque
+//    nouveau bloc jusqu'à atteindre ARENA__CHUNK_MAX octets. Une demande plus
+//    grande que la taille courante donne lieu à un bloc de taille adaptée.
+
+#define ARENA__CHUNK_MIN 4096
+#define ARENA__CHUNK_MAX (1 << 24)
+
+//  struct achunk, achunk : bloc de l'arène. Le composant capacity mémorise le
+//    nombre d'octets du tableau data, used le nombre d'octets déjà attribués
+//    depuis son début et next l'adresse du bloc alloué précédemment.
+
+typedef struct achunk achunk;
+
+struct achunk {
+  achunk *next;
+  size_t capacity;
+  size_t used;
+  max_align_t data[];
+};
+
+//  struct arena, arena : liste simplement chainée des blocs, le plus récent en
+//    tête. Seul le bloc de tête est utilisé pour les nouvelles allocations.
+//    Le composant nextsize mémorise la taille du prochain bloc à allouer.
+
+struct arena {
+  achunk *head;
+  size_t nextsize;
+};
+
+#define ALIGN_UP(n, a) (((n) + ((a) - 1)) & ~((a) - 1))
+
+arena *arena_empty(void) {
+  arena *ar = malloc(sizeof *ar);
+  if (ar == NULL) {
+    return NULL;
+  }
+  ar->head = NULL;
+  ar->nextsize = ARENA__CHUNK_MIN;
+  return ar;
+}
+
+void *arena_alloc(arena *ar, size_t size, size_t align) {
+  achunk *c = ar->head;
+  if (c != NULL) {
+    size_t off = ALIGN_UP(c->used, align);
+    if (off <= c->capacity && size <= c->capacity - off) {
+      c->used = off + size;
+      return (unsigned char *) c->data + off;
+    }
+  }
+  size_t m = ar->nextsize;
+  if (size > m) {
+    m = size;
+  }
+  if (m > SIZE_MAX - sizeof *c
+      || (c = malloc(sizeof *c + m)) == NULL) {
+    return NULL;
+  }
+  if (ar->nextsize < ARENA__CHUNK_MAX) {
+    ar->nextsize *= 2;
+  }
+  c->next = ar->head;
+  c->capacity = m;
+  c->used = size;
+  ar->head = c;
+  return c->data;
+}
+
+void arena_dispose(arena **arptr) {
+  if (*arptr == NULL) {
+    return;
+  }
+  achunk *c = (*arptr)->head;
+  while (c != NULL) {
+    achunk *t = c;
+    c = c->next;
+    free(t);
+  }
+  free(*arptr);
+  *arptr = NULL;
+}
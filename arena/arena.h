@@ -0,0 +1,39 @@
+//  arena : Un module permettant d'allouer de nombreuses petites zones mémoire
+//    par découpage de gros blocs, toutes libérées ensemble en une seule fois.
+//    Les blocs sont mémorisés dans une structure nommée « arena ».
+
+#ifndef ARENA__H
+#define ARENA__H
+
+#include <stdlib.h>
+
+//  Fonctionnement général :
+//  - une zone allouée par arena_alloc ne peut pas être libérée
+//      individuellement : elle reste valide jusqu'à la libération de l'arène
+//      par arena_dispose ;
+//  - le nombre de blocs alloués croît de manière logarithmique avec la
+//      quantité de mémoire demandée, si bien que arena_dispose s'exécute en un
+//      temps indépendant en pratique du nombre de zones allouées.
+
+//  struct arena, arena : type et nom de type d'un contrôleur regroupant les
+//    informations nécessaires pour gérer une arène.
+typedef struct arena arena;
+
+//  arena_empty : tente d'allouer les ressources nécessaires pour gérer une
+//    nouvelle arène initialement vide. Renvoie NULL en cas de dépassement de
+//    capacité. Renvoie sinon un pointeur vers le contrôleur associé à l'arène.
+extern arena *arena_empty(void);
+
+//  arena_alloc : tente d'allouer dans l'arène associée à ar une zone mémoire de
+//    size octets dont l'adresse est un multiple de align. La valeur de align
+//    doit être une puissance de 2 qui n'excède pas l'alignement du type
+//    max_align_t. Renvoie NULL en cas de dépassement de capacité. Renvoie sinon
+//    l'adresse de la zone allouée.
+extern void *arena_alloc(arena *ar, size_t size, size_t align);
+
+//  arena_dispose : sans effet si *arptr vaut NULL. Libère sinon toutes les
+//    zones allouées dans l'arène associée à *arptr ainsi que les ressources
+//    allouées à sa gestion puis affecte NULL à *arptr.
+extern void arena_dispose(arena **arptr);
+
+#endif
@@ -0,0 +1,627 @@
+//  Partie implantation du module art.
+
+#include "art.h"
+#include <stdalign.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "arena.h"
+
+//  Types des nœuds : une feuille mémorise un couple, un nœud interne de type
+//    ART__NODEk possède au plus k fils.
+enum {
+  ART__LEAF,
+  ART__NODE4,
+  ART__NODE16,
+  ART__NODE48,
+  ART__NODE256
+};
+
+//  ART__TYPE : type du nœud d'adresse p, feuille ou nœud interne, qui est
+//    mémorisé par le premier composant de chacune de leurs structures.
+#define ART__TYPE(p) (*(const unsigned char *) (p))
+
+//  ART__STACK_NFRAMES : capacité initiale de la pile de parcours de art_apply.
+#define ART__STACK_NFRAMES 64
+
+//  struct leaf, leaf : couple entry dont la clé est de longueur len.
+typedef struct {
+  unsigned char type;
+  size_t len;
+  art_entry entry;
+} leaf;
+
+//  header : en-tête commun aux nœuds internes. n est le nombre de fils, plen
+//    la longueur du préfixe mémorisé à la fin de la structure du nœud, que les
+//    clés des descendants partagent après les octets connus des ancêtres, et
+//    term, s'il ne vaut pas NULL, la feuille dont la clé se termine avec ce
+//    préfixe.
+typedef struct {
+  unsigned char type;
+  unsigned int n;
+  size_t plen;
+  leaf *term;
+} header;
+
+//  node4, node16 : les n premières composantes de keys sont, dans l'ordre
+//    croissant, les octets qui mènent aux fils de mêmes indices.
+typedef struct {
+  header h;
+  unsigned char keys[4];
+  void *children[4];
+  unsigned char prefix[];
+} node4;
+
+typedef struct {
+  header h;
+  unsigned char keys[16];
+  void *children[16];
+  unsigned char prefix[];
+} node16;
+
+//  node48 : index[c], s'il est non nul, est un de plus que l'indice dans
+//    children du fils auquel mène l'octet c.
+typedef struct {
+  header h;
+  unsigned char index[256];
+  void *children[48];
+  unsigned char prefix[];
+} node48;
+
+//  node256 : children[c] est le fils auquel mène l'octet c, NULL à défaut.
+typedef struct {
+  header h;
+  void *children[256];
+  unsigned char prefix[];
+} node256;
+
+//  struct frame, frame : nœud interne en cours de parcours par art_apply, step
+//    étant le nombre d'emplacements, feuille term comprise, déjà visités.
+typedef struct {
+  header *h;
+  size_t step;
+} frame;
+
+//  struct art, art : root est l'adresse de la racine, une feuille ou un nœud
+//    interne, NULL si l'arbre est vide. size est le nombre de couples. Les
+//    nœuds sont alloués dans l'arène ar. stack est la pile de parcours de
+//    art_apply, de capacité nframes. Chaque nœud interne d'un chemin depuis la
+//    racine consomme au moins un octet de plus que le précédent, si bien
+//    qu'un chemin compte au plus un nœud interne de plus que la longueur de la
+//    plus longue clé : la capacité de la pile est maintenue au-delà de cette
+//    valeur à chaque ajout, et art_apply n'alloue rien.
+struct art {
+  void *root;
+  size_t size;
+  arena *ar;
+  frame *stack;
+  size_t nframes;
+};
+
+//  art__prefix : renvoie l'adresse du préfixe du nœud interne associé à h.
+static unsigned char *art__prefix(header *h) {
+  switch (h->type) {
+    case ART__NODE4:
+      return ((node4 *) h)->prefix;
+    case ART__NODE16:
+      return ((node16 *) h)->prefix;
+    case ART__NODE48:
+      return ((node48 *) h)->prefix;
+    default:
+      return ((node256 *) h)->prefix;
+  }
+}
+
+//  art__nslots : renvoie le nombre d'emplacements de fils du nœud interne
+//    associé à h que parcourt art__child_at.
+static size_t art__nslots(const header *h) {
+  return h->type == ART__NODE4 || h->type == ART__NODE16 ? h->n : 256;
+}
+
+//  art__child_at : renvoie le fils d'emplacement k du nœud interne associé à
+//    h, NULL si l'emplacement est vide, et affecte à *cptr l'octet qui y mène.
+//    Les emplacements sont dans l'ordre croissant des octets.
+static void *art__child_at(header *h, size_t k, unsigned char *cptr) {
+  switch (h->type) {
+    case ART__NODE4:
+      *cptr = ((node4 *) h)->keys[k];
+      return ((node4 *) h)->children[k];
+    case ART__NODE16:
+      *cptr = ((node16 *) h)->keys[k];
+      return ((node16 *) h)->children[k];
+    case ART__NODE48: {
+      node48 *p = (node48 *) h;
+      *cptr = (unsigned char) k;
+      return p->index[k] == 0 ? NULL : p->children[p->index[k] - 1];
+    }
+    default:
+      *cptr = (unsigned char) k;
+      return ((node256 *) h)->children[k];
+  }
+}
+
+//  art__find_child : renvoie l'adresse du lien du nœud interne associé à h
+//    vers le fils auquel mène l'octet c, NULL si ce fils n'existe pas.
+static void **art__find_child(header *h, unsigned char c) {
+  unsigned char *keys;
+  void **children;
+  switch (h->type) {
+    case ART__NODE4:
+      keys = ((node4 *) h)->keys;
+      children = ((node4 *) h)->children;
+      break;
+    case ART__NODE16:
+      keys = ((node16 *) h)->keys;
+      children = ((node16 *) h)->children;
+      break;
+    case ART__NODE48: {
+      node48 *p = (node48 *) h;
+      return p->index[c] == 0 ? NULL : &p->children[p->index[c] - 1];
+    }
+    default: {
+      node256 *p = (node256 *) h;
+      return p->children[c] == NULL ? NULL : &p->children[c];
+    }
+  }
+  for (unsigned int k = 0; k < h->n && keys[k] <= c; ++k) {
+    if (keys[k] == c) {
+      return &children[k];
+    }
+  }
+  return NULL;
+}
+
+//  art__is_full : indique si le nœud interne associé à h a atteint sa
+//    capacité.
+static bool art__is_full(const header *h) {
+  switch (h->type) {
+    case ART__NODE4:
+      return h->n == 4;
+    case ART__NODE16:
+      return h->n == 16;
+    case ART__NODE48:
+      return h->n == 48;
+    default:
+      return false;
+  }
+}
+
+//  art__add_child : ajoute au nœud interne non plein associé à h le fils child
+//    auquel mène l'octet c, qui ne mène à aucun autre fils.
+static void art__add_child(header *h, unsigned char c, void *child) {
+  unsigned char *keys;
+  void **children;
+  switch (h->type) {
+    case ART__NODE4:
+      keys = ((node4 *) h)->keys;
+      children = ((node4 *) h)->children;
+      break;
+    case ART__NODE16:
+      keys = ((node16 *) h)->keys;
+      children = ((node16 *) h)->children;
+      break;
+    case ART__NODE48: {
+      node48 *p = (node48 *) h;
+      p->children[h->n] = child;
+      h->n += 1;
+      p->index[c] = (unsigned char) h->n;
+      return;
+    }
+    default:
+      ((node256 *) h)->children[c] = child;
+      h->n += 1;
+      return;
+  }
+  unsigned int k = 0;
+  while (k < h->n && keys[k] < c) {
+    ++k;
+  }
+  memmove(&keys[k + 1], &keys[k], (h->n - k) * sizeof keys[0]);
+  memmove(&children[k + 1], &children[k], (h->n - k) * sizeof children[0]);
+  keys[k] = c;
+  children[k] = child;
+  h->n += 1;
+}
+
+//  art__remove_child : retire du nœud interne associé à h le fils auquel mène
+//    l'octet c, qui doit exister.
+static void art__remove_child(header *h, unsigned char c) {
+  unsigned char *keys;
+  void **children;
+  switch (h->type) {
+    case ART__NODE4:
+      keys = ((node4 *) h)->keys;
+      children = ((node4 *) h)->children;
+      break;
+    case ART__NODE16:
+      keys = ((node16 *) h)->keys;
+      children = ((node16 *) h)->children;
+      break;
+    case ART__NODE48: {
+      node48 *p = (node48 *) h;
+      unsigned int k = p->index[c];
+      p->index[c] = 0;
+      h->n -= 1;
+      if (k <= h->n) {
+        p->children[k - 1] = p->children[h->n];
+        for (size_t d = 0; d < 256; ++d) {
+          if (p->index[d] == h->n + 1) {
+            p->index[d] = (unsigned char) k;
+            break;
+          }
+        }
+      }
+      return;
+    }
+    default:
+      ((node256 *) h)->children[c] = NULL;
+      h->n -= 1;
+      return;
+  }
+  unsigned int k = 0;
+  while (keys[k] != c) {
+    ++k;
+  }
+  h->n -= 1;
+  memmove(&keys[k], &keys[k + 1], (h->n - k) * sizeof keys[0]);
+  memmove(&children[k], &children[k + 1], (h->n - k) * sizeof children[0]);
+}
+
+//  art__node_new : tente d'allouer dans l'arène de at un nouveau nœud interne
+//    de type type, sans fils, dont le préfixe est formé des plen octets qui
+//    commencent à l'adresse prefix. Renvoie NULL en cas de dépassement de
+//    capacité, l'adresse de l'en-tête du nœud sinon.
+static header *art__node_new(art *at, unsigned char type,
+    const unsigned char *prefix, size_t plen) {
+  size_t size;
+  size_t align;
+  switch (type) {
+    case ART__NODE4:
+      size = sizeof(node4);
+      align = alignof(node4);
+      break;
+    case ART__NODE16:
+      size = sizeof(node16);
+      align = alignof(node16);
+      break;
+    case ART__NODE48:
+      size = sizeof(node48);
+      align = alignof(node48);
+      break;
+    default:
+      size = sizeof(node256);
+      align = alignof(node256);
+      break;
+  }
+  header *h = arena_alloc(at->ar, size + plen, align);
+  if (h == NULL) {
+    return NULL;
+  }
+  memset(h, 0, size);
+  h->type = type;
+  h->plen = plen;
+  memcpy(art__prefix(h), prefix, plen);
+  return h;
+}
+
+//  art__grow : tente de remplacer le nœud interne plein associé à *ref par un
+//    nœud de capacité supérieure, de mêmes préfixe, fils et feuille term.
+//    Renvoie NULL en cas de dépassement de capacité, l'adresse de l'en-tête du
+//    nouveau nœud sinon. L'ancien nœud reste alloué dans l'arène.
+static header *art__grow(art *at, void **ref) {
+  header *h = *ref;
+  header *g = art__node_new(at, (unsigned char) (h->type + 1), art__prefix(h),
+      h->plen);
+  if (g == NULL) {
+    return NULL;
+  }
+  g->term = h->term;
+  size_t ns = art__nslots(h);
+  for (size_t k = 0; k < ns; ++k) {
+    unsigned char c;
+    void *child = art__child_at(h, k, &c);
+    if (child != NULL) {
+      art__add_child(g, c, child);
+    }
+  }
+  *ref = g;
+  return g;
+}
+
+//  art__leaf_new : tente d'allouer dans l'arène de at une nouvelle feuille
+//    mémorisant le couple (key, NULL), la clé étant de longueur len. Renvoie
+//    NULL en cas de dépassement de capacité, l'adresse de la feuille sinon.
+static leaf *art__leaf_new(art *at, const void *key, size_t len) {
+  leaf *l = arena_alloc(at->ar, sizeof *l, alignof(leaf));
+  if (l == NULL) {
+    return NULL;
+  }
+  l->type = ART__LEAF;
+  l->len = len;
+  l->entry.keyref = key;
+  l->entry.valref = NULL;
+  return l;
+}
+
+//  art__place : ajoute au nœud interne associé à h la feuille l, dont les
+//    depth premiers octets de la clé sont connus de h et de ses ancêtres, en
+//    tant que feuille term si sa clé n'a pas d'autre octet, en tant que fils
+//    auquel mène son octet d'indice depth sinon.
+static void art__place(header *h, leaf *l, size_t depth) {
+  if (l->len == depth) {
+    h->term = l;
+  } else {
+    const unsigned char *u = l->entry.keyref;
+    art__add_child(h, u[depth], l);
+  }
+}
+
+art *art_empty(void) {
+  art *at = malloc(sizeof *at);
+  if (at == NULL) {
+    return NULL;
+  }
+  at->ar = arena_empty();
+  if (at->ar == NULL) {
+    free(at);
+    return NULL;
+  }
+  at->stack = malloc(ART__STACK_NFRAMES * sizeof *at->stack);
+  if (at->stack == NULL) {
+    arena_dispose(&at->ar);
+    free(at);
+    return NULL;
+  }
+  at->nframes = ART__STACK_NFRAMES;
+  at->root = NULL;
+  at->size = 0;
+  return at;
+}
+
+void art_dispose(art **atptr) {
+  if (*atptr == NULL) {
+    return;
+  }
+  arena_dispose(&(*atptr)->ar);
+  free((*atptr)->stack);
+  free(*atptr);
+  *atptr = NULL;
+}
+
+//  art__reserve : tente de porter la capacité de la pile de parcours de at à
+//    au moins len + 1 nœuds. Renvoie une valeur non nulle en cas de
+//    dépassement de capacité. Renvoie sinon zéro.
+static int art__reserve(art *at, size_t len) {
+  if (len < at->nframes) {
+    return 0;
+  }
+  size_t n = len < at->nframes * 2 ? at->nframes * 2 : len + 1;
+  if (n <= len || n > SIZE_MAX / sizeof *at->stack) {
+    return -1;
+  }
+  frame *stack = realloc(at->stack, n * sizeof *stack);
+  if (stack == NULL) {
+    return -1;
+  }
+  at->stack = stack;
+  at->nframes = n;
+  return 0;
+}
+
+art_entry *art_find_or_insert(art *at, const void *key, size_t len) {
+  if (art__reserve(at, len) != 0) {
+    return NULL;
+  }
+  const unsigned char *s = key;
+  void **ref = &at->root;
+  size_t depth = 0;
+  while (true) {
+    void *p = *ref;
+    if (p == NULL) {
+      leaf *nl = art__leaf_new(at, key, len);
+      if (nl == NULL) {
+        return NULL;
+      }
+      *ref = nl;
+      at->size += 1;
+      return &nl->entry;
+    }
+    if (ART__TYPE(p) == ART__LEAF) {
+      leaf *l = p;
+      const unsigned char *u = l->entry.keyref;
+      if (l->len == len && memcmp(u + depth, s + depth, len - depth) == 0) {
+        return &l->entry;
+      }
+      size_t m = (l->len < len ? l->len : len) - depth;
+      size_t q = 0;
+      while (q < m && u[depth + q] == s[depth + q]) {
+        ++q;
+      }
+      header *h = art__node_new(at, ART__NODE4, s + depth, q);
+      leaf *nl = art__leaf_new(at, key, len);
+      if (h == NULL || nl == NULL) {
+        return NULL;
+      }
+      art__place(h, l, depth + q);
+      art__place(h, nl, depth + q);
+      *ref = h;
+      at->size += 1;
+      return &nl->entry;
+    }
+    header *h = p;
+    if (h->plen > 0) {
+      unsigned char *pre = art__prefix(h);
+      size_t m = h->plen < len - depth ? h->plen : len - depth;
+      size_t q = 0;
+      while (q < m && pre[q] == s[depth + q]) {
+        ++q;
+      }
+      if (q < h->plen) {
+        header *g = art__node_new(at, ART__NODE4, pre, q);
+        leaf *nl = art__leaf_new(at, key, len);
+        if (g == NULL || nl == NULL) {
+          return NULL;
+        }
+        unsigned char c = pre[q];
+        h->plen -= q + 1;
+        memmove(pre, pre + q + 1, h->plen);
+        art__add_child(g, c, h);
+        art__place(g, nl, depth + q);
+        *ref = g;
+        at->size += 1;
+        return &nl->entry;
+      }
+      depth += h->plen;
+    }
+    if (depth == len) {
+      if (h->term != NULL) {
+        return &h->term->entry;
+      }
+      leaf *nl = art__leaf_new(at, key, len);
+      if (nl == NULL) {
+        return NULL;
+      }
+      h->term = nl;
+      at->size += 1;
+      return &nl->entry;
+    }
+    void **c = art__find_child(h, s[depth]);
+    if (c != NULL) {
+      ref = c;
+      ++depth;
+      continue;
+    }
+    if (art__is_full(h) && (h = art__grow(at, ref)) == NULL) {
+      return NULL;
+    }
+    leaf *nl = art__leaf_new(at, key, len);
+    if (nl == NULL) {
+      return NULL;
+    }
+    art__add_child(h, s[depth], nl);
+    at->size += 1;
+    return &nl->entry;
+  }
+}
+
+void *art_search(art *at, const void *key, size_t len) {
+  const unsigned char *s = key;
+  void *p = at->root;
+  size_t depth = 0;
+  while (p != NULL) {
+    if (ART__TYPE(p) == ART__LEAF) {
+      leaf *l = p;
+      const unsigned char *u = l->entry.keyref;
+      return l->len == len && memcmp(u + depth, s + depth, len - depth) == 0
+        ? (void *) l->entry.valref
+        : NULL;
+    }
+    header *h = p;
+    if (h->plen > 0) {
+      if (len - depth < h->plen
+          || memcmp(art__prefix(h), s + depth, h->plen) != 0) {
+        return NULL;
+      }
+      depth += h->plen;
+    }
+    if (depth == len) {
+      p = h->term;
+    } else {
+      void **c = art__find_child(h, s[depth]);
+      p = c == NULL ? NULL : *c;
+      ++depth;
+    }
+  }
+  return NULL;
+}
+
+void *art_remove(art *at, const void *key, size_t len) {
+  const unsigned char *s = key;
+  void *p = at->root;
+  header *parent = NULL;
+  size_t depth = 0;
+  while (p != NULL && ART__TYPE(p) != ART__LEAF) {
+    header *h = p;
+    if (h->plen > 0) {
+      if (len - depth < h->plen
+          || memcmp(art__prefix(h), s + depth, h->plen) != 0) {
+        return NULL;
+      }
+      depth += h->plen;
+    }
+    parent = h;
+    if (depth == len) {
+      p = h->term;
+    } else {
+      void **c = art__find_child(h, s[depth]);
+      p = c == NULL ? NULL : *c;
+      ++depth;
+    }
+  }
+  if (p == NULL) {
+    return NULL;
+  }
+  leaf *l = p;
+  const unsigned char *u = l->entry.keyref;
+  if (l->len != len || memcmp(u + depth, s + depth, len - depth) != 0) {
+    return NULL;
+  }
+  if (parent == NULL) {
+    at->root = NULL;
+  } else if (parent->term == l) {
+    parent->term = NULL;
+  } else {
+    art__remove_child(parent, s[depth - 1]);
+  }
+  at->size -= 1;
+  return (void *) l->entry.valref;
+}
+
+size_t art_size(art *at) {
+  return at->size;
+}
+
+int art_apply(art *at, int dir, int (*fun)(void *)) {
+  void *p = at->root;
+  if (p == NULL) {
+    return 0;
+  }
+  if (ART__TYPE(p) == ART__LEAF) {
+    return fun((void *) ((leaf *) p)->entry.valref);
+  }
+  frame *stack = at->stack;
+  size_t k = 0;
+  stack[k] = (frame) {
+    .h = p, .step = 0
+  };
+  ++k;
+  while (k > 0) {
+    frame *f = &stack[k - 1];
+    size_t ns = art__nslots(f->h);
+    if (f->step > ns) {
+      --k;
+      continue;
+    }
+    size_t step = f->step;
+    f->step += 1;
+    unsigned char c;
+    void *child = dir <= 0
+      ? (step == 0 ? f->h->term : art__child_at(f->h, step - 1, &c))
+      : (step == ns ? f->h->term : art__child_at(f->h, ns - 1 - step, &c));
+    if (child == NULL) {
+      continue;
+    }
+    if (ART__TYPE(child) == ART__LEAF) {
+      int r = fun((void *) ((leaf *) child)->entry.valref);
+      if (r != 0) {
+        return r;
+      }
+      continue;
+    }
+    stack[k] = (frame) {
+      .h = child, .step = 0
+    };
+    ++k;
+  }
+  return 0;
+}
@@ -0,0 +1,99 @@
+//  art : Un module permettant d'associer des références de valeurs à des clés
+//    qui sont des suites d'octets, mémorisées dans un arbre radix adaptatif
+//    nommé « art » et parcourues dans l'ordre lexicographique.
+
+#ifndef ART__H
+#define ART__H
+
+#include <stdlib.h>
+
+//  Fonctionnement général :
+//  - une clé est une suite d'octets repérée par son adresse et sa longueur.
+//      Ses octets ne sont pas copiés : ils doivent rester accessibles et
+//      inchangés tant que la clé est présente dans l'arbre ;
+//  - chaque nœud interne est repéré par un préfixe commun aux clés de ses
+//      descendants, dont il mémorise une copie des octets qui ne sont pas déjà
+//      connus de ses ancêtres, puis possède au plus un fils par valeur de
+//      l'octet suivant. Les préfixes communs ne sont ainsi mémorisés qu'une
+//      fois et une recherche compare chaque octet de la clé au plus une fois,
+//      sans appel à une fonction de comparaison ;
+//  - un nœud interne a une capacité de 4, 16, 48 ou 256 fils, augmentée au
+//      besoin. Une clé dont aucune autre clé n'est un prolongement est
+//      mémorisée dès qu'elle se distingue des autres, sans nœud interne
+//      supplémentaire ;
+//  - les clés sont ordonnées selon l'ordre lexicographique de leurs octets,
+//      vus comme des unsigned char, une clé étant inférieure à celles dont elle
+//      est un préfixe propre ;
+//  - les nœuds sont alloués par blocs et ne sont libérés qu'avec l'arbre, par
+//      art_dispose ;
+//  - les fonctions qui possèdent un paramètre de type « art * » ou « art ** »
+//      ont un comportement indéterminé lorsque ce paramètre ou sa déréférence
+//      n'est pas l'adresse d'un contrôleur préalablement renvoyée avec succès
+//      par la fonction art_empty et non révoquée depuis par la fonction
+//      art_dispose ;
+//  - les fonctions de type de retour « void * » renvoient NULL en cas d'échec.
+//      En cas de succès, elles renvoient une référence de valeur actuellement
+//      ou auparavant stockée par la structure de données.
+
+//  struct art, art : type et nom de type d'un contrôleur regroupant les
+//    informations nécessaires pour gérer un arbre radix adaptatif.
+typedef struct art art;
+
+//  struct art_entry, art_entry : type et nom de type d'un couple formé de
+//    l'adresse des octets d'une clé et d'une référence de valeur.
+typedef struct art_entry art_entry;
+
+struct art_entry {
+  const void *keyref;
+  const void *valref;
+};
+
+//  art_empty : tente d'allouer les ressources nécessaires pour gérer un nouvel
+//    arbre radix adaptatif initialement vide. Renvoie NULL en cas de
+//    dépassement de capacité. Renvoie sinon un pointeur vers le contrôleur
+//    associé à l'arbre.
+extern art *art_empty(void);
+
+//  art_dispose : sans effet si *atptr vaut NULL. Libère sinon les ressources
+//    allouées à la gestion de l'arbre radix adaptatif associé à *atptr puis
+//    affecte NULL à *atptr.
+extern void art_dispose(art **atptr);
+
+//  art_find_or_insert : recherche dans l'arbre radix adaptatif associé à at la
+//    clé de longueur len dont les octets commencent à l'adresse key. Si la
+//    recherche est positive, renvoie l'adresse du couple correspondant. Tente
+//    sinon d'ajouter le couple (key, NULL) à l'arbre ; renvoie NULL en cas de
+//    dépassement de capacité ; renvoie sinon l'adresse du couple ajouté. Le
+//    composant valref du couple renvoyé vaut donc NULL si et seulement si le
+//    couple vient d'être ajouté : avant tout autre appel d'une fonction du
+//    module avec at, il faut alors lui affecter une référence non nulle, la
+//    référence keyref pouvant aussi être remplacée par l'adresse d'octets
+//    égaux, ou bien retirer le couple avec art_remove. L'adresse renvoyée
+//    reste valide jusqu'au retrait du couple.
+extern art_entry *art_find_or_insert(art *at, const void *key, size_t len);
+
+//  art_search : recherche dans l'arbre radix adaptatif associé à at la clé de
+//    longueur len dont les octets commencent à l'adresse key. Renvoie NULL si
+//    la recherche est négative, la référence de la valeur correspondante
+//    sinon.
+extern void *art_search(art *at, const void *key, size_t len);
+
+//  art_remove : recherche dans l'arbre radix adaptatif associé à at la clé de
+//    longueur len dont les octets commencent à l'adresse key. Si la recherche
+//    est négative, renvoie NULL. Retire sinon le couple correspondant de
+//    l'arbre et renvoie la référence de la valeur qui lui était associée.
+extern void *art_remove(art *at, const void *key, size_t len);
+
+//  art_size : renvoie le nombre de couples de l'arbre radix adaptatif associé
+//    à at.
+extern size_t art_size(art *at);
+
+//  art_apply : exécute fun sur les références des valeurs de l'arbre radix
+//    adaptatif associé à at, dans l'ordre croissant ou décroissant des clés
+//    selon que la valeur de dir est inférieure ou égale à zéro ou non. Si,
+//    pour une référence, fun renvoie une valeur non nulle, l'exécution prend
+//    fin et art_apply renvoie cette valeur. Sinon, fun est exécutée sur toutes
+//    les références et art_apply renvoie zéro.
+extern int art_apply(art *at, int dir, int (*fun)(void *));
+
+#endif
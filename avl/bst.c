@@ -2,6 +2,7 @@
 //   ABINR du TDA ABinR(T).
 
 #include "bst.h"
+#include <stdbool.h>
 
 #define DISPLAY_ROTATION
 
@@ -11,10 +12,13 @@
 
 typedef struct cbst cbst;
 
+//  struct cbst : le composant size mémorise la taille du sous-arbre dont le
+//    nœud est la racine.
 struct cbst {
   cbst *next[2];
   const void *ref;
   int height;
+  size_t size;
 };
 
 //--- Raccourcis cbst ----------------------------------------------------------
@@ -25,14 +29,11 @@ struct cbst {
 #define RIGHT(p)    ((p)->next[1])
 #define REF(p)      ((p)->ref)
 #define HEIGHT(p) ((p)->height)
+#define SIZE(p)     ((p)->size)
 #define NEXT(p, d)  ((p)->next[(d) > 0])
 
 //--- Divers -------------------------------------------------------------------
 
-static size_t add__size_t(size_t x1, size_t x2) {
-  return x1 + x2;
-}
-
 static int max__int(int x1, int x2) {
   return x1 > x2 ? x1 : x2;
 }
@@ -41,23 +42,106 @@ static int min__int(int x1, int x2) {
   return x1 < x2 ? x1 : x2;
 }
 
-//--- Fonctions cbst -----------------------------------------------------------
+//--- Réserve cbst -------------------------------------------------------------
+
+//  Les nœuds sont alloués par blocs dont le nombre de nœuds vaut initialement
+//    CBST__CHUNK_NNODES_MIN puis double d'un bloc à l'autre jusqu'à
+//    CBST__CHUNK_NNODES_MAX. Les nœuds ajoutés successivement sont ainsi
+//    contigus en mémoire.
+
+#define CBST__CHUNK_NNODES_MIN 64
+#define CBST__CHUNK_NNODES_MAX 65536
+
+#if CBST__CHUNK_NNODES_MIN < 1                                                 \
+  || CBST__CHUNK_NNODES_MAX < CBST__CHUNK_NNODES_MIN
+#error Bad choice of CBST__CHUNK_ constants.
+#endif
+
+typedef struct chunk chunk;
+
+struct chunk {
+  chunk *next;
+  size_t nnodes;
+  cbst nodes[];
+};
+
+//  struct pool, pool : les blocs forment une liste simplement chainée de tête
+//    chunks, le bloc de tête étant le dernier alloué ; ses nœuds sont attribués
+//    dans l'ordre et chunkfree mémorise le nombre de ceux qui ne l'ont pas
+//    encore été. Les nœuds retirés de l'arbre forment une liste simplement
+//    chainée par leur composant next[0], de tête freenodes ; ils sont
+//    réutilisés en priorité.
+typedef struct pool pool;
+
+struct pool {
+  chunk *chunks;
+  size_t chunkfree;
+  cbst *freenodes;
+};
+
+//  pool__init : initialise la réserve associée à pl à vide.
+static void pool__init(pool *pl) {
+  pl->chunks = NULL;
+  pl->chunkfree = 0;
+  pl->freenodes = NULL;
+}
 
-//  DEFUN_CBST__MEASURE : définit la fonction récursive de nom « cbst__ ## fun »
-//    et de paramètre un pointeur d'arbre binaire, qui renvoie zéro si l'arbre
-//    est vide et « 1 + oper(r0, r1) » sinon, où r0 et r1 sont les valeurs
-//    renvoyées par les appels récursifs de la fonction avec les pointeurs des
-//    sous-arbres gauche et droit de l'arbre comme paramètres.
-#define DEFUN_CBST__MEASURE(fun, oper)                                         \
-  static size_t cbst__ ## fun(const cbst * p) {                                \
-    return IS_EMPTY(p)                                                         \
-      ? 0                                                                      \
-      : 1 + oper(cbst__ ## fun(LEFT(p)), cbst__ ## fun(RIGHT(p)));             \
+//  pool__alloc : renvoie l'adresse d'un nœud inutilisé de la réserve associée
+//    à pl, pris dans la liste des nœuds retirés si elle n'est pas vide, dans le
+//    bloc de tête sinon, un nouveau bloc étant alloué si celui-ci est épuisé.
+//    Renvoie NULL en cas de dépassement de capacité.
+static cbst *pool__alloc(pool *pl) {
+  if (pl->freenodes != NULL) {
+    cbst *p = pl->freenodes;
+    pl->freenodes = LEFT(p);
+    return p;
+  }
+  if (pl->chunkfree == 0) {
+    size_t n = CBST__CHUNK_NNODES_MIN;
+    if (pl->chunks != NULL) {
+      n = pl->chunks->nnodes < CBST__CHUNK_NNODES_MAX / 2
+        ? 2 * pl->chunks->nnodes
+        : CBST__CHUNK_NNODES_MAX;
+    }
+    chunk *c = malloc(sizeof *c + n * sizeof(cbst));
+    if (c == NULL) {
+      return NULL;
+    }
+    c->next = pl->chunks;
+    c->nnodes = n;
+    pl->chunks = c;
+    pl->chunkfree = n;
   }
+  cbst *p = &pl->chunks->nodes[pl->chunks->nnodes - pl->chunkfree];
+  pl->chunkfree -= 1;
+  return p;
+}
+
+//  pool__free : ajoute le nœud d'adresse p à la liste des nœuds retirés de la
+//    réserve associée à pl.
+static void pool__free(pool *pl, cbst *p) {
+  LEFT(p) = pl->freenodes;
+  pl->freenodes = p;
+}
+
+//  pool__dispose : libère les blocs de la réserve associée à pl.
+static void pool__dispose(pool *pl) {
+  chunk *c = pl->chunks;
+  while (c != NULL) {
+    chunk *t = c;
+    c = c->next;
+    free(t);
+  }
+  pool__init(pl);
+}
+
+//--- Fonctions cbst -----------------------------------------------------------
 
 //  cbst__size, cbst__height, cbst__distance : définition.
 
-DEFUN_CBST__MEASURE(size, add__size_t)
+static size_t cbst__size(const cbst *p) {
+  return IS_EMPTY(p) ? 0 : SIZE(p);
+}
 
 static int cbst__height(const cbst *p) {
   return IS_EMPTY(p) ? 0 : HEIGHT(p);
@@ -68,9 +152,11 @@ static int cbst__distance(const cbst *p) {
     + min__int(cbst__distance(LEFT(p)), cbst__distance(RIGHT(p)));
 }
 
-//  cbst_update_height: Met à jour la hauteur du sous-arbre non vide associé à p
+//  cbst_update_height: Met à jour la hauteur et la taille du sous-arbre non
+//    vide associé à p
 static void cbst__update_height(cbst *p) {
   HEIGHT(p) = 1 + max__int(cbst__height(RIGHT(p)), cbst__height(LEFT(p)));
+  SIZE(p) = 1 + cbst__size(LEFT(p)) + cbst__size(RIGHT(p));
 }
 
 //  cbst_balance:  renvoie l’équilibre du sous-arbre associé à p
@@ -144,95 +230,101 @@ static int cbst__balancing(cbst **pp) {
   return r;
 }
 
-//  cbst__dispose : libère les ressources allouées à l'arbre binaire pointé par
-//    p.
-static void cbst__dispose(cbst *p) {
-  if (!IS_EMPTY(p)) {
-    cbst__dispose(LEFT(p));
-    cbst__dispose(RIGHT(p));
-    free(p);
+//  CBST__PATH_MAX : nombre maximal de liens mémorisés lors de la descente
+//    depuis la racine. La hauteur d'un arbre AVL de n nœuds est majorée par
+//    1.45 * log2(n + 2), soit moins de 96 pour tout n représentable.
+#define CBST__PATH_MAX 128
+
+//  cbst__climbup : ajoute delta à la taille des sous-arbres associés à
+//    *path[0], ..., *path[k - 1], puis les rééquilibre dans l'ordre inverse et
+//    s'arrête au premier dont la hauteur est inchangée : ceux qui le
+//    contiennent sont alors équilibrés.
+static void cbst__climbup(cbst ***path, size_t k, int delta) {
+  for (size_t j = 0; j < k; ++j) {
+    SIZE(*path[j]) += (size_t) delta;
+  }
+  while (k > 0) {
+    --k;
+    int h = HEIGHT(*path[k]);
+    cbst__balancing(path[k]);
+    if (HEIGHT(*path[k]) == h) {
+      return;
+    }
   }
 }
 
-//  cbst_add_endofpath : Recherche dans le sous-arbre binaire de recherche
+//  cbst__find_or_insert : Recherche dans le sous-arbre binaire de recherche
 //    associé à *pp la référence d'un objet égal à celui de référence ref au
 //    sens de la fonction de comparaison. Si la recherche est positive, renvoie
-//    la référence trouvée. Tente sinon d'ajouter la référence selon la méthode
-//    de l'ajout en bout de chemin. Renvoie NULL en cas de dépassement de
-//    capacité; renvoie ref sinon.
-static void *cbst__add_endofpath(cbst **pp, const void *ref,
-    int (*compar)(const void *, const void *)) {
-  if (IS_EMPTY(*pp)) {
-    *pp = malloc(sizeof **pp);
-    if (pp == NULL) {
-      return NULL;
+//    l'adresse de la référence trouvée. Tente sinon d'ajouter la référence
+//    selon la méthode de l'ajout en bout de chemin. Renvoie NULL en cas de
+//    dépassement de capacité; renvoie l'adresse de la référence ajoutée sinon.
+//    Le nœud ajouté est pris dans la réserve associée à pl.
+static const void **cbst__find_or_insert(cbst **pp, const void *ref,
+    int (*compar)(const void *, const void *), pool *pl) {
+  cbst **path[CBST__PATH_MAX];
+  size_t k = 0;
+  while (!IS_EMPTY(*pp)) {
+    int c = compar(ref, REF(*pp));
+    if (c == 0) {
+      return &REF(*pp);
     }
-    REF(*pp) = ref;
-    LEFT(*pp) = EMPTY();
-    RIGHT(*pp) = EMPTY();
-    HEIGHT(*pp) = 1;
-    return (void *) ref;
-  }
-  int c = compar(ref, REF(*pp));
-  if (c == 0) {
-    return (void *) REF(*pp);
-  }
-  void *r = cbst__add_endofpath(&NEXT(*pp, c), ref, compar);
-  if (r == (void *) ref) {
-    cbst__balancing(&(*pp));
+    path[k] = pp;
+    ++k;
+    pp = &NEXT(*pp, c);
   }
-  return r;
-}
-
-//  cbst__remove_max : Retire le noeud de valeur maximale du sous-arbre binaire
-//    de recherche non vide associé à *pp.
-static void *cbst__remove_max(cbst **pp) {
-  if (IS_EMPTY(RIGHT(*pp))) {
-    void *r = (void *) REF(*pp);
-    cbst *p = *pp;
-    *pp = LEFT(p);
-    free(p);
-    return r;
-  }
-  void *res = cbst__remove_max(&RIGHT(*pp));
-  cbst__balancing(&(*pp));
-  return res;
-}
-
-//  cbst__remove_root: Retire la racine du sous-arbre binaire de recherche non
-//     vide associé à *pp si son sous-arbre gauche est vide. Retire sinon le
-//     noeud de valeur maximale de son sous-arbre gauche et remplace la
-//     référence de la racine par celle de la valeur maximale retirée.
-static void cbst__remove_root(cbst **pp) {
-  if (IS_EMPTY(LEFT(*pp))) {
-    cbst *p = *pp;
-    *pp = RIGHT(p);
-    free(p);
-    return;
+  cbst *p = pool__alloc(pl);
+  if (p == NULL) {
+    return NULL;
   }
-  REF(*pp) = cbst__remove_max(&LEFT(*pp));
-  cbst__balancing(&(*pp));
+  REF(p) = ref;
+  LEFT(p) = EMPTY();
+  RIGHT(p) = EMPTY();
+  HEIGHT(p) = 1;
+  SIZE(p) = 1;
+  *pp = p;
+  cbst__climbup(path, k, 1);
+  return &REF(p);
 }
 
 //  cbst_remove_climbup_left : Recherche dans le sous-arbre binaire de recherche
 //    associé à *pp la référence d'un objet égal à celui de référence ref au
 //    sens de la fonction de comparaison. Si la recherche est négative,
 //    renvoie NULL. Retire sinon la référence trouvée selon la méthode du
-//    retrait par remontée gauche et renvoie la référence trouvée.
+//    retrait par remontée gauche et renvoie la référence trouvée. Le nœud
+//    retiré est rendu à la réserve associée à pl.
 static void *cbst__remove_climbup_left(cbst **pp, const void *ref,
-    int (*compar)(const void *, const void *)) {
+    int (*compar)(const void *, const void *), pool *pl) {
+  cbst **path[CBST__PATH_MAX];
+  size_t k = 0;
+  int c;
+  while (!IS_EMPTY(*pp) && (c = compar(ref, REF(*pp))) != 0) {
+    path[k] = pp;
+    ++k;
+    pp = &NEXT(*pp, c);
+  }
   if (IS_EMPTY(*pp)) {
     return EMPTY();
   }
-  int c = compar(ref, REF(*pp));
-  if (c == 0) {
-    cbst__remove_root(pp);
-    return (void *) ref;
-  }
-  void *r = cbst__remove_climbup_left(&NEXT(*pp, c), ref, compar);
-  if (r != NULL) {
-    cbst__balancing(&(*pp));
+  void *r = (void *) REF(*pp);
+  cbst *p = *pp;
+  if (IS_EMPTY(LEFT(p))) {
+    *pp = RIGHT(p);
+  } else {
+    path[k] = pp;
+    ++k;
+    pp = &LEFT(p);
+    while (!IS_EMPTY(RIGHT(*pp))) {
+      path[k] = pp;
+      ++k;
+      pp = &RIGHT(*pp);
+    }
+    REF(p) = REF(*pp);
+    p = *pp;
+    *pp = LEFT(p);
   }
+  pool__free(pl, p);
+  cbst__climbup(path, k, -1);
   return r;
 }
 
@@ -242,14 +334,11 @@ static void *cbst__remove_climbup_left(cbst **pp, const void *ref,
 //    la référence trouvée sinon.
 static void *cbst__search(const cbst *p, const void *ref,
     int (*compar)(const void *, const void *)) {
-  if (IS_EMPTY(p)) {
-    return EMPTY();
-  }
-  int c = compar(ref, REF(p));
-  if (c == 0) {
-    return (void *) REF(p);
+  int c;
+  while (!IS_EMPTY(p) && (c = compar(ref, REF(p))) != 0) {
+    p = NEXT(p, c);
   }
-  return cbst__search(NEXT(p, c), ref, compar);
+  return IS_EMPTY(p) ? EMPTY() : (void *) REF(p);
 }
 
 //  cbsr__number : Calcule le numéro du nœud du sous-arbre binaire de recherche
@@ -274,15 +363,78 @@ static size_t cbst__number(const cbst *p, const void *ref,
 //    ajoutée à l'arbre.
 static size_t cbst__rank(const cbst *p, const void *ref,
     int (*compar)(const void *, const void *), size_t rank) {
-  if (IS_EMPTY(p)) {
-    return rank;
+  while (!IS_EMPTY(p)) {
+    int c = compar(ref, REF(p));
+    if (c == 0) {
+      return rank + cbst__size(LEFT(p));
+    }
+    if (c > 0) {
+      rank += 1 + cbst__size(LEFT(p));
+    }
+    p = NEXT(p, c);
   }
-  int c = compar(ref, REF(p));
-  if (c == 0) {
-    return rank + cbst__size(LEFT(p));
+  return rank;
+}
+
+//  cbst__select : renvoie la référence stockée par le nœud de rang k du
+//    sous-arbre binaire de recherche associé à p, NULL si k est supérieur ou
+//    égal à la taille du sous-arbre.
+static void *cbst__select(const cbst *p, size_t k) {
+  if (k >= cbst__size(p)) {
+    return NULL;
+  }
+  while (k != cbst__size(LEFT(p))) {
+    size_t s = cbst__size(LEFT(p));
+    if (k < s) {
+      p = LEFT(p);
+    } else {
+      k -= s + 1;
+      p = RIGHT(p);
+    }
+  }
+  return (void *) REF(p);
+}
+
+//  cbst__dft_infix_apply_context : parcourt en profondeur, de manière infixe,
+//    l'arbre binaire pointé par p, le premier sous-arbre de chaque nœud étant
+//    next[d] et le second next[!d], selon la spécification de la fonction
+//    bst_dft_infix_apply_context. Les nœuds dont le second sous-arbre est en
+//    cours de parcours, ou reste à parcourir, sont mémorisés dans une pile
+//    dont second indique l'état.
+static int cbst__dft_infix_apply_context(const cbst *p, int d,
+    void *context, int (*fun)(void *context, const void *ref),
+    int (*fun_pre)(void *context), int (*fun_post)(void *context)) {
+  struct {
+    const cbst *node;
+    bool second;
+  } stack[CBST__PATH_MAX];
+  size_t k = 0;
+  int r;
+  while (true) {
+    while (!IS_EMPTY(p)) {
+      if (fun_pre != NULL && (r = fun_pre(context)) != 0) {
+        return r;
+      }
+      stack[k].node = p;
+      stack[k].second = false;
+      ++k;
+      p = p->next[d];
+    }
+    while (k > 0 && stack[k - 1].second) {
+      if (fun_post != NULL && (r = fun_post(context)) != 0) {
+        return r;
+      }
+      --k;
+    }
+    if (k == 0) {
+      return 0;
+    }
+    stack[k - 1].second = true;
+    if ((r = fun(context, REF(stack[k - 1].node))) != 0) {
+      return r;
+    }
+    p = stack[k - 1].node->next[!d];
   }
-  return cbst__rank(NEXT(p, c), ref, compar, rank + (c < 0 ? 0
-      : 1 + cbst__size(LEFT(p))));
 }
 
 #define REPR__TAB 4
@@ -315,9 +467,12 @@ static void cbst__repr_graphic(const cbst *p,
 
 //--- Définition bst -----------------------------------------------------------
 
+//  struct bst : les nœuds de l'arbre de racine root sont pris dans la réserve
+//    nodes.
 struct bst {
   int (*compar)(const void *, const void *);
   cbst *root;
+  pool nodes;
 };
 
 //--- Fonctions bst ------------------------------------------------------------
@@ -329,6 +484,7 @@ bst *bst_empty(int (*compar)(const void *, const void *)) {
   }
   t->compar = compar;
   t->root = EMPTY();
+  pool__init(&t->nodes);
   return t;
 }
 
@@ -336,7 +492,7 @@ void bst_dispose(bst **tptr) {
   if (*tptr == NULL) {
     return;
   }
-  cbst__dispose((*tptr)->root);
+  pool__dispose(&(*tptr)->nodes);
   free(*tptr);
   *tptr = NULL;
 }
@@ -345,14 +501,23 @@ void *bst_add_endofpath(bst *t, const void *ref) {
   if (ref == NULL) {
     return NULL;
   }
-  return cbst__add_endofpath(&t->root, ref, t->compar);
+  const void **r = cbst__find_or_insert(&t->root, ref, t->compar,
+      &t->nodes);
+  return r == NULL ? NULL : (void *) *r;
+}
+
+const void **bst_find_or_insert(bst *t, const void *ref) {
+  if (ref == NULL) {
+    return NULL;
+  }
+  return cbst__find_or_insert(&t->root, ref, t->compar, &t->nodes);
 }
 
 extern void *bst_remove_climbup_left(bst *t, const void *ref) {
   if (ref == NULL) {
     return NULL;
   }
-  return cbst__remove_climbup_left(&t->root, ref, t->compar);
+  return cbst__remove_climbup_left(&t->root, ref, t->compar, &t->nodes);
 }
 
 void *bst_search(bst *t, const void *ref) {
@@ -394,6 +559,17 @@ size_t bst_rank(bst *t, const void *ref) {
   return cbst__rank(t->root, ref, t->compar, 0);
 }
 
+void *bst_select(bst *t, size_t k) {
+  return cbst__select(t->root, k);
+}
+
 void bst_repr_graphic(bst *t, void (*put)(const void *ref)) {
   cbst__repr_graphic(t->root, put, 0);
 }
+
+int bst_dft_infix_apply_context(bst *t, int dir,
+    void *context, int (*fun)(void *context, const void *ref),
+    int (*fun_pre)(void *context), int (*fun_post)(void *context)) {
+  return cbst__dft_infix_apply_context(t->root, dir > 0, context, fun,
+      fun_pre, fun_post);
+}
@@ -53,6 +53,18 @@ extern void bst_dispose(bst **tptr);
 //    renvoie NULL en cas de dépassement de capacité ; renvoie sinon ref.
 extern void *bst_add_endofpath(bst *t, const void *ref);
 
+//  bst_find_or_insert : renvoie NULL si ref vaut NULL. Recherche sinon dans
+//    l'arbre binaire de recherche associé à t la référence d'un objet égal à
+//    celui de référence ref au sens de la fonction de comparaison. Si la
+//    recherche est positive, renvoie l'adresse de la référence trouvée. Tente
+//    sinon d'ajouter la référence selon la méthode de l'ajout en bout de
+//    chemin ; renvoie NULL en cas de dépassement de capacité ; renvoie sinon
+//    l'adresse de la référence ajoutée. Un seul chemin est parcouru dans les
+//    deux cas. La référence pointée vaut donc ref si et seulement si elle
+//    vient d'être ajoutée : elle peut alors être remplacée par celle d'un
+//    objet égal. L'adresse renvoyée reste valide jusqu'au prochain retrait.
+extern const void **bst_find_or_insert(bst *t, const void *ref);
+
 //  bst_remove_climbup_left : renvoie NULL si ref vaut NULL. Recherche sinon
 //    dans l'arbre binaire de recherche associé à t la référence d'un objet égal
 //    à celui de référence ref au sens de la fonction de comparaison. Si la
@@ -68,7 +80,8 @@ extern void *bst_remove_climbup_left(bst *t, const void *ref);
 extern void *bst_search(bst *t, const void *ref);
 
 //  bst_size, bst_height, bst_distance : renvoie la taille, la hauteur, la
-//    distance de l'arbre binaire de recherche associé à t.
+//    distance de l'arbre binaire de recherche associé à t. La taille et la
+//    hauteur sont mémorisées et obtenues en temps constant.
 extern size_t bst_size(bst *t);
 extern size_t bst_height(bst *t);
 extern size_t bst_distance(bst *t);
@@ -82,6 +95,12 @@ extern size_t bst_distance(bst *t);
 extern size_t bst_number(bst *t, const void *ref);
 extern size_t bst_rank(bst *t, const void *ref);
 
+//  bst_select : renvoie la référence stockée par le nœud de rang k de l'arbre
+//    binaire de recherche associé à t, c'est-à-dire la référence ref telle que
+//    bst_rank(t, ref) vaut k. Renvoie NULL si k est supérieur ou égal à la
+//    taille de l'arbre.
+extern void *bst_select(bst *t, size_t k);
+
 //  bst_repr_graphic : affiche sur la sortie standard une représentation
 //    graphique de l'arbre binaire de recherche associé à t. La fonction put est
 //    utilisée pour l'affichage de chacune des valeurs dont les références sont
@@ -0,0 +1,479 @@
+//  Partie implantation du module btree.
+
+#include "btree.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+//  BTREE__LEAF_NKEYS, BTREE__INNER_NKEYS : nombres maximaux de clés d'une
+//    feuille et d'un nœud interne. Les entiers de tête d'un nœud occupent
+//    ainsi quatre lignes de cache de 64 octets.
+#define BTREE__LEAF_NKEYS 32
+#define BTREE__INNER_NKEYS 32
+
+#if BTREE__LEAF_NKEYS < 4 || BTREE__INNER_NKEYS < 4
+#error Bad choice of BTREE__ NKEYS constants.
+#endif
+
+//  BTREE__PREFIX_MAX : longueur maximale du préfixe commun mémorisé par une
+//    feuille.
+#define BTREE__PREFIX_MAX 24
+
+//  BTREE__DEPTH_MAX : nombre maximal de niveaux de nœuds internes. Un nœud
+//    interne autre que la racine a au moins BTREE__INNER_NKEYS / 2 fils et
+//    une feuille reçoit au moins BTREE__LEAF_NKEYS / 2 ajouts avant d'être
+//    scindée, si bien que ce nombre n'est pas atteint en pratique.
+#define BTREE__DEPTH_MAX 24
+
+//  BTREE__HEAD_SIZE : nombre d'octets d'une clé mémorisés par un entier de
+//    tête.
+#define BTREE__HEAD_SIZE 8
+
+//  struct leaf, leaf : les n premières composantes des tableaux heads, lens
+//    et entries décrivent les clés de la feuille, dans l'ordre croissant. Les
+//    plen premiers octets de ces clés sont égaux à ceux du tableau prefix ;
+//    heads[k] est l'entier de tête de la k-ième clé à partir de l'octet plen.
+//    next[0] et next[1] sont les adresses des feuilles précédente et suivante,
+//    NULL à défaut.
+typedef struct leaf leaf;
+
+struct leaf {
+  size_t n;
+  size_t plen;
+  leaf *next[2];
+  uint64_t heads[BTREE__LEAF_NKEYS];
+  size_t lens[BTREE__LEAF_NKEYS];
+  btree_entry entries[BTREE__LEAF_NKEYS];
+  unsigned char prefix[BTREE__PREFIX_MAX];
+};
+
+//  struct inner, inner : les n premières composantes des tableaux heads, lens
+//    et keys décrivent les clés séparatrices du nœud, dans l'ordre croissant,
+//    heads[k] étant l'entier de tête de la k-ième clé. Les clés du sous-arbre
+//    children[k] sont supérieures ou égales à la (k - 1)-ième séparatrice et
+//    strictement inférieures à la k-ième.
+typedef struct inner inner;
+
+struct inner {
+  size_t n;
+  uint64_t heads[BTREE__INNER_NKEYS];
+  size_t lens[BTREE__INNER_NKEYS];
+  const void *keys[BTREE__INNER_NKEYS];
+  void *children[BTREE__INNER_NKEYS + 1];
+};
+
+//  struct btree, btree : root est l'adresse de la racine, une feuille si
+//    height vaut zéro, un nœud interne au-dessus de height niveaux sinon. size
+//    mémorise le nombre de couples. ends[0] et ends[1] sont les adresses de la
+//    première et de la dernière feuille.
+struct btree {
+  void *root;
+  size_t height;
+  size_t size;
+  leaf *ends[2];
+};
+
+//  step : type d'un nœud interne traversé lors d'une descente, associé à
+//    l'indice du fils emprunté.
+typedef struct {
+  inner *node;
+  size_t index;
+} step;
+
+//  btree__head : renvoie l'entier dont les octets, du poids fort au poids
+//    faible, sont les BTREE__HEAD_SIZE octets qui suivent les from premiers
+//    octets de la clé de longueur n qui commence à l'adresse s, complétés si
+//    besoin par des zéros.
+static uint64_t btree__head(const unsigned char *s, size_t n, size_t from) {
+  uint64_t h = 0;
+  for (size_t k = from; k < from + BTREE__HEAD_SIZE; ++k) {
+    h = (h << 8) | (k < n ? s[k] : 0);
+  }
+  return h;
+}
+
+//  btree__compar : compare les clés de longueurs n et m qui commencent aux
+//    adresses s et t, dont les from premiers octets sont égaux et dont les
+//    entiers de tête à partir de from valent hs et ht. Renvoie une valeur
+//    strictement négative, nulle ou strictement positive selon que la première
+//    est inférieure, égale ou supérieure à la seconde. Les octets ne sont lus
+//    que si les entiers de tête sont égaux et que les deux clés sont plus
+//    longues que from + BTREE__HEAD_SIZE.
+static int btree__compar(const unsigned char *s, size_t n, uint64_t hs,
+    const unsigned char *t, size_t m, uint64_t ht, size_t from) {
+  if (hs != ht) {
+    return hs > ht ? 1 : -1;
+  }
+  size_t skip = from + BTREE__HEAD_SIZE;
+  if (n > skip && m > skip) {
+    int c = memcmp(s + skip, t + skip, (n < m ? n : m) - skip);
+    if (c != 0) {
+      return c;
+    }
+  }
+  return n == m ? 0 : n > m ? 1 : -1;
+}
+
+//  btree__leaf_search : renvoie la position, dans la feuille associée à lf,
+//    de la première clé supérieure ou égale à la clé de longueur n qui
+//    commence à l'adresse s. Affecte à *found l'égalité des deux clés.
+static size_t btree__leaf_search(const leaf *lf, const unsigned char *s,
+    size_t n, bool *found) {
+  *found = false;
+  if (lf->n == 0) {
+    return 0;
+  }
+  size_t p = lf->plen;
+  int c = memcmp(s, lf->prefix, n < p ? n : p);
+  if (c < 0 || (c == 0 && n < p)) {
+    return 0;
+  }
+  if (c > 0) {
+    return lf->n;
+  }
+  uint64_t h = btree__head(s, n, p);
+  size_t lo = 0;
+  size_t hi = lf->n;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    if (lf->heads[mid] < h) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  while (lo < lf->n && lf->heads[lo] == h) {
+    c = btree__compar(s, n, h, lf->entries[lo].keyref, lf->lens[lo], h, p);
+    if (c <= 0) {
+      *found = c == 0;
+      return lo;
+    }
+    ++lo;
+  }
+  return lo;
+}
+
+//  btree__inner_search : renvoie l'indice du fils du nœud interne associé à
+//    in dont le sous-arbre peut contenir la clé de longueur n qui commence à
+//    l'adresse s et dont l'entier de tête vaut h.
+static size_t btree__inner_search(const inner *in, const unsigned char *s,
+    size_t n, uint64_t h) {
+  size_t lo = 0;
+  size_t hi = in->n;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    if (in->heads[mid] <= h) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  while (lo > 0 && in->heads[lo - 1] == h
+      && btree__compar(s, n, h, in->keys[lo - 1], in->lens[lo - 1], h, 0)
+      < 0) {
+    --lo;
+  }
+  return lo;
+}
+
+//  btree__descend : renvoie l'adresse de la feuille du B+arbre associé à bt
+//    qui peut contenir la clé de longueur n qui commence à l'adresse s. Si
+//    path ne vaut pas NULL, mémorise dans path[0], ..., path[height - 1] les
+//    nœuds internes traversés depuis la racine.
+static leaf *btree__descend(const btree *bt, const unsigned char *s, size_t n,
+    step *path) {
+  void *p = bt->root;
+  uint64_t h = btree__head(s, n, 0);
+  for (size_t d = 0; d < bt->height; ++d) {
+    inner *in = p;
+    size_t k = btree__inner_search(in, s, n, h);
+    if (path != NULL) {
+      path[d] = (step) {
+        .node = in, .index = k
+      };
+    }
+    p = in->children[k];
+  }
+  return p;
+}
+
+//  btree__leaf_reprefix : affecte au préfixe de la feuille non vide associée à
+//    lf le plus long préfixe commun à ses clés, dans la limite de
+//    BTREE__PREFIX_MAX octets, puis recalcule les entiers de tête.
+static void btree__leaf_reprefix(leaf *lf) {
+  const unsigned char *s = lf->entries[0].keyref;
+  const unsigned char *t = lf->entries[lf->n - 1].keyref;
+  size_t m = lf->lens[0] < lf->lens[lf->n - 1]
+    ? lf->lens[0] : lf->lens[lf->n - 1];
+  m = m < BTREE__PREFIX_MAX ? m : BTREE__PREFIX_MAX;
+  size_t p = 0;
+  while (p < m && s[p] == t[p]) {
+    ++p;
+  }
+  lf->plen = p;
+  memcpy(lf->prefix, s, p);
+  for (size_t k = 0; k < lf->n; ++k) {
+    lf->heads[k] = btree__head(lf->entries[k].keyref, lf->lens[k], p);
+  }
+}
+
+//  btree__leaf_insert : ajoute à la position pos de la feuille non pleine
+//    associée à lf le couple formé de la clé de longueur n qui commence à
+//    l'adresse s et de NULL. Renvoie l'adresse du couple ajouté.
+static btree_entry *btree__leaf_insert(leaf *lf, size_t pos,
+    const unsigned char *s, size_t n) {
+  if (lf->n == 0) {
+    lf->plen = n < BTREE__PREFIX_MAX ? n : BTREE__PREFIX_MAX;
+    memcpy(lf->prefix, s, lf->plen);
+  } else {
+    size_t p = 0;
+    while (p < lf->plen && p < n && s[p] == lf->prefix[p]) {
+      ++p;
+    }
+    if (p < lf->plen) {
+      lf->plen = p;
+      for (size_t k = 0; k < lf->n; ++k) {
+        lf->heads[k] = btree__head(lf->entries[k].keyref, lf->lens[k], p);
+      }
+    }
+  }
+  size_t m = lf->n - pos;
+  memmove(&lf->heads[pos + 1], &lf->heads[pos], m * sizeof lf->heads[0]);
+  memmove(&lf->lens[pos + 1], &lf->lens[pos], m * sizeof lf->lens[0]);
+  memmove(&lf->entries[pos + 1], &lf->entries[pos],
+      m * sizeof lf->entries[0]);
+  lf->heads[pos] = btree__head(s, n, lf->plen);
+  lf->lens[pos] = n;
+  lf->entries[pos] = (btree_entry) {
+    .keyref = s, .valref = NULL
+  };
+  lf->n += 1;
+  return &lf->entries[pos];
+}
+
+//  btree__inner_insert : ajoute à la position k du nœud interne non plein
+//    associé à in la séparatrice de longueur n qui commence à l'adresse s,
+//    suivie du fils child.
+static void btree__inner_insert(inner *in, size_t k, const unsigned char *s,
+    size_t n, void *child) {
+  size_t m = in->n - k;
+  memmove(&in->heads[k + 1], &in->heads[k], m * sizeof in->heads[0]);
+  memmove(&in->lens[k + 1], &in->lens[k], m * sizeof in->lens[0]);
+  memmove(&in->keys[k + 1], &in->keys[k], m * sizeof in->keys[0]);
+  memmove(&in->children[k + 2], &in->children[k + 1],
+      m * sizeof in->children[0]);
+  in->heads[k] = btree__head(s, n, 0);
+  in->lens[k] = n;
+  in->keys[k] = s;
+  in->children[k + 1] = child;
+  in->n += 1;
+}
+
+//  btree__grow : ajoute au B+arbre associé à bt, au-dessus de la feuille
+//    atteinte par les height pas de path, la séparatrice de longueur n qui
+//    commence à l'adresse s, suivie du fils child. Les nœuds internes pleins
+//    sont scindés en prenant leurs nouveaux voisins droits dans spare, qui
+//    contient aussi la nouvelle racine si celle-ci est scindée.
+static void btree__grow(btree *bt, step *path, const unsigned char *s,
+    size_t n, void *child, inner **spare) {
+  size_t d = bt->height;
+  while (d > 0) {
+    --d;
+    inner *in = path[d].node;
+    size_t k = path[d].index;
+    if (in->n < BTREE__INNER_NKEYS) {
+      btree__inner_insert(in, k, s, n, child);
+      return;
+    }
+    inner *r = *spare;
+    ++spare;
+    size_t m = in->n / 2;
+    const unsigned char *ps = in->keys[m];
+    size_t pn = in->lens[m];
+    r->n = in->n - m - 1;
+    memcpy(r->heads, &in->heads[m + 1], r->n * sizeof r->heads[0]);
+    memcpy(r->lens, &in->lens[m + 1], r->n * sizeof r->lens[0]);
+    memcpy(r->keys, &in->keys[m + 1], r->n * sizeof r->keys[0]);
+    memcpy(r->children, &in->children[m + 1],
+        (r->n + 1) * sizeof r->children[0]);
+    in->n = m;
+    if (k <= m) {
+      btree__inner_insert(in, k, s, n, child);
+    } else {
+      btree__inner_insert(r, k - m - 1, s, n, child);
+    }
+    s = ps;
+    n = pn;
+    child = r;
+  }
+  inner *root = *spare;
+  root->n = 0;
+  root->children[0] = bt->root;
+  btree__inner_insert(root, 0, s, n, child);
+  bt->root = root;
+  bt->height += 1;
+}
+
+//  btree__insert_split : ajoute à la position pos de la feuille pleine
+//    associée à lf, atteinte par les pas de path, le couple formé de la clé de
+//    longueur n qui commence à l'adresse s et de NULL. La feuille est scindée
+//    au préalable, de sorte que seules des clés déjà présentes servent de
+//    séparatrices. Renvoie NULL en cas de dépassement de capacité, l'adresse
+//    du couple ajouté sinon.
+static btree_entry *btree__insert_split(btree *bt, step *path, leaf *lf,
+    size_t pos, const unsigned char *s, size_t n) {
+  size_t nsplit = 0;
+  while (nsplit < bt->height
+      && path[bt->height - 1 - nsplit].node->n == BTREE__INNER_NKEYS) {
+    ++nsplit;
+  }
+  if (nsplit == bt->height && bt->height == BTREE__DEPTH_MAX) {
+    return NULL;
+  }
+  size_t ninner = nsplit + (nsplit == bt->height);
+  inner *spare[BTREE__DEPTH_MAX + 1];
+  leaf *r = malloc(sizeof *r);
+  size_t k = 0;
+  while (r != NULL && k < ninner
+      && (spare[k] = malloc(sizeof *spare[k])) != NULL) {
+    ++k;
+  }
+  if (r == NULL || k < ninner) {
+    while (k > 0) {
+      --k;
+      free(spare[k]);
+    }
+    free(r);
+    return NULL;
+  }
+  size_t m = lf->n / 2;
+  r->n = lf->n - m;
+  memcpy(r->lens, &lf->lens[m], r->n * sizeof r->lens[0]);
+  memcpy(r->entries, &lf->entries[m], r->n * sizeof r->entries[0]);
+  lf->n = m;
+  r->next[0] = lf;
+  r->next[1] = lf->next[1];
+  if (lf->next[1] != NULL) {
+    lf->next[1]->next[0] = r;
+  } else {
+    bt->ends[1] = r;
+  }
+  lf->next[1] = r;
+  btree__leaf_reprefix(lf);
+  btree__leaf_reprefix(r);
+  btree__grow(bt, path, r->entries[0].keyref, r->lens[0], r, spare);
+  return pos <= m
+    ? btree__leaf_insert(lf, pos, s, n)
+    : btree__leaf_insert(r, pos - m, s, n);
+}
+
+btree *btree_empty(void) {
+  btree *bt = malloc(sizeof *bt);
+  if (bt == NULL) {
+    return NULL;
+  }
+  leaf *lf = malloc(sizeof *lf);
+  if (lf == NULL) {
+    free(bt);
+    return NULL;
+  }
+  lf->n = 0;
+  lf->plen = 0;
+  lf->next[0] = NULL;
+  lf->next[1] = NULL;
+  bt->root = lf;
+  bt->height = 0;
+  bt->size = 0;
+  bt->ends[0] = lf;
+  bt->ends[1] = lf;
+  return bt;
+}
+
+//  btree__dispose_inner : libère les nœuds internes du sous-arbre de racine
+//    le nœud interne associé à in, situé au-dessus de height niveaux de nœuds
+//    internes.
+static void btree__dispose_inner(inner *in, size_t height) {
+  if (height > 1) {
+    for (size_t k = 0; k <= in->n; ++k) {
+      btree__dispose_inner(in->children[k], height - 1);
+    }
+  }
+  free(in);
+}
+
+void btree_dispose(btree **btptr) {
+  if (*btptr == NULL) {
+    return;
+  }
+  btree *bt = *btptr;
+  if (bt->height > 0) {
+    btree__dispose_inner(bt->root, bt->height);
+  }
+  leaf *lf = bt->ends[0];
+  while (lf != NULL) {
+    leaf *t = lf;
+    lf = lf->next[1];
+    free(t);
+  }
+  free(bt);
+  *btptr = NULL;
+}
+
+btree_entry *btree_find_or_insert(btree *bt, const void *key, size_t len) {
+  step path[BTREE__DEPTH_MAX];
+  leaf *lf = btree__descend(bt, key, len, path);
+  bool found;
+  size_t pos = btree__leaf_search(lf, key, len, &found);
+  if (found) {
+    return &lf->entries[pos];
+  }
+  btree_entry *e = lf->n < BTREE__LEAF_NKEYS
+    ? btree__leaf_insert(lf, pos, key, len)
+    : btree__insert_split(bt, path, lf, pos, key, len);
+  if (e != NULL) {
+    bt->size += 1;
+  }
+  return e;
+}
+
+void *btree_search(btree *bt, const void *key, size_t len) {
+  leaf *lf = btree__descend(bt, key, len, NULL);
+  bool found;
+  size_t pos = btree__leaf_search(lf, key, len, &found);
+  return found ? (void *) lf->entries[pos].valref : NULL;
+}
+
+void *btree_remove(btree *bt, const void *key, size_t len) {
+  leaf *lf = btree__descend(bt, key, len, NULL);
+  bool found;
+  size_t pos = btree__leaf_search(lf, key, len, &found);
+  if (!found) {
+    return NULL;
+  }
+  void *r = (void *) lf->entries[pos].valref;
+  size_t m = lf->n - pos - 1;
+  memmove(&lf->heads[pos], &lf->heads[pos + 1], m * sizeof lf->heads[0]);
+  memmove(&lf->lens[pos], &lf->lens[pos + 1], m * sizeof lf->lens[0]);
+  memmove(&lf->entries[pos], &lf->entries[pos + 1],
+      m * sizeof lf->entries[0]);
+  lf->n -= 1;
+  bt->size -= 1;
+  return r;
+}
+
+size_t btree_size(btree *bt) {
+  return bt->size;
+}
+
+int btree_apply(btree *bt, int dir, int (*fun)(void *)) {
+  int d = dir > 0;
+  for (leaf *lf = bt->ends[d]; lf != NULL; lf = lf->next[!d]) {
+    for (size_t k = 0; k < lf->n; ++k) {
+      int r = fun((void *) lf->entries[d ? lf->n - 1 - k : k].valref);
+      if (r != 0) {
+        return r;
+      }
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,93 @@
+//  btree : Un module permettant d'associer des références de valeurs à des
+//    clés qui sont des suites d'octets, mémorisées dans un B+arbre nommé
+//    « btree » et parcourues dans l'ordre lexicographique.
+
+#ifndef BTREE__H
+#define BTREE__H
+
+#include <stdlib.h>
+
+//  Fonctionnement général :
+//  - une clé est une suite d'octets repérée par son adresse et sa longueur.
+//      Ses octets ne sont pas copiés : ils doivent rester accessibles et
+//      inchangés jusqu'à la libération de l'arbre, même après le retrait de
+//      la clé, car ils peuvent servir de séparateurs dans les nœuds internes ;
+//  - les clés sont ordonnées selon l'ordre lexicographique de leurs octets,
+//      vus comme des unsigned char, une clé étant inférieure à celles dont elle
+//      est un préfixe propre ;
+//  - les nœuds sont larges et occupent plusieurs lignes de cache. Chaque
+//      feuille mémorise un préfixe commun à toutes ses clés, puis, pour chaque
+//      clé, les 8 octets qui le suivent sous forme d'entier : la plupart des
+//      comparaisons sont ainsi conclues sans accéder aux octets des clés ;
+//  - les feuilles sont chainées dans les deux sens, ce qui permet de parcourir
+//      les couples dans l'ordre des clés sans parcourir les nœuds internes ;
+//  - un retrait ne réorganise pas l'arbre : une feuille peut devenir vide ;
+//  - les fonctions qui possèdent un paramètre de type « btree * » ou
+//      « btree ** » ont un comportement indéterminé lorsque ce paramètre ou sa
+//      déréférence n'est pas l'adresse d'un contrôleur préalablement renvoyée
+//      avec succès par la fonction btree_empty et non révoquée depuis par la
+//      fonction btree_dispose ;
+//  - les fonctions de type de retour « void * » renvoient NULL en cas d'échec.
+//      En cas de succès, elles renvoient une référence de valeur actuellement
+//      ou auparavant stockée par la structure de données.
+
+//  struct btree, btree : type et nom de type d'un contrôleur regroupant les
+//    informations nécessaires pour gérer un B+arbre.
+typedef struct btree btree;
+
+//  struct btree_entry, btree_entry : type et nom de type d'un couple formé de
+//    l'adresse des octets d'une clé et d'une référence de valeur.
+typedef struct btree_entry btree_entry;
+
+struct btree_entry {
+  const void *keyref;
+  const void *valref;
+};
+
+//  btree_empty : tente d'allouer les ressources nécessaires pour gérer un
+//    nouveau B+arbre initialement vide. Renvoie NULL en cas de dépassement de
+//    capacité. Renvoie sinon un pointeur vers le contrôleur associé à l'arbre.
+extern btree *btree_empty(void);
+
+//  btree_dispose : sans effet si *btptr vaut NULL. Libère sinon les ressources
+//    allouées à la gestion du B+arbre associé à *btptr puis affecte NULL à
+//    *btptr.
+extern void btree_dispose(btree **btptr);
+
+//  btree_find_or_insert : recherche dans le B+arbre associé à bt la clé de
+//    longueur len dont les octets commencent à l'adresse key. Si la recherche
+//    est positive, renvoie l'adresse du couple correspondant. Tente sinon
+//    d'ajouter le couple (key, NULL) à l'arbre ; renvoie NULL en cas de
+//    dépassement de capacité ; renvoie sinon l'adresse du couple ajouté. Le
+//    composant valref du couple renvoyé vaut donc NULL si et seulement si le
+//    couple vient d'être ajouté : avant tout autre appel d'une fonction du
+//    module avec bt, il faut alors lui affecter une référence non nulle, la
+//    référence keyref pouvant aussi être remplacée par l'adresse d'octets
+//    égaux, ou bien retirer le couple avec btree_remove. L'adresse renvoyée
+//    reste valide jusqu'au prochain appel d'une fonction du module avec bt.
+extern btree_entry *btree_find_or_insert(btree *bt, const void *key,
+    size_t len);
+
+//  btree_search : recherche dans le B+arbre associé à bt la clé de longueur len
+//    dont les octets commencent à l'adresse key. Renvoie NULL si la recherche
+//    est négative, la référence de la valeur correspondante sinon.
+extern void *btree_search(btree *bt, const void *key, size_t len);
+
+//  btree_remove : recherche dans le B+arbre associé à bt la clé de longueur len
+//    dont les octets commencent à l'adresse key. Si la recherche est négative,
+//    renvoie NULL. Retire sinon le couple correspondant de l'arbre et renvoie
+//    la référence de la valeur qui lui était associée.
+extern void *btree_remove(btree *bt, const void *key, size_t len);
+
+//  btree_size : renvoie le nombre de couples du B+arbre associé à bt.
+extern size_t btree_size(btree *bt);
+
+//  btree_apply : exécute fun sur les références des valeurs du B+arbre associé
+//    à bt, dans l'ordre croissant ou décroissant des clés selon que la valeur
+//    de dir est inférieure ou égale à zéro ou non. Si, pour une référence,
+//    fun renvoie une valeur non nulle, l'exécution prend fin et btree_apply
+//    renvoie cette valeur. Sinon, fun est exécutée sur toutes les références
+//    et btree_apply renvoie zéro.
+extern int btree_apply(btree *bt, int dir, int (*fun)(void *));
+
+#endif
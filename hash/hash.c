@@ -0,0 +1,30 @@
+//  Partie implantation du module hash.
+
+#include "hash.h"
+#include <time.h>
+
+//  hash__anchor : objet dont l'adresse, qui varie d'une exécution à l'autre
+//    lorsque l'espace d'adressage est rendu aléatoire, contribue à la graine.
+static const char hash__anchor;
+
+uint64_t hash_seed(void) {
+  struct timespec ts;
+  timespec_get(&ts, TIME_UTC);
+  uint64_t s = (uint64_t) ts.tv_sec ^ ((uint64_t) ts.tv_nsec << 32);
+  s ^= (uint64_t) (uintptr_t) &ts;
+  s ^= (uint64_t) (uintptr_t) &hash__anchor;
+  s ^= (uint64_t) clock();
+  return hash__mix(s ^ HASH__P0, HASH__P1);
+}
+
+uint64_t hash_bytes(const void *s, size_t n, uint64_t seed) {
+  const unsigned char *p = s;
+  uint64_t state = hash_start(seed);
+  size_t i = n;
+  while (i > HASH_BLOCK) {
+    state = hash_step(state, p);
+    p += HASH_BLOCK;
+    i -= HASH_BLOCK;
+  }
+  return hash_finish(state, s, n);
+}
@@ -0,0 +1,123 @@
+//  hash : Un module de fonctions de hachage de suites d'octets, inspirées de
+//    wyhash, et paramétrées par une graine.
+//  Les octets sont lus par mots de 8 octets et mélangés par multiplication
+//    64 × 64 → 128 bits. Choisir la graine aléatoirement à chaque exécution
+//    rend imprévisibles les collisions, ce qui protège une table de hachage
+//    contre des entrées construites pour les provoquer.
+//  Le calcul peut aussi être mené au fil de la lecture d'une suite d'octets
+//    contigus dont la longueur n'est pas encore connue : hash_start, puis
+//    hash_step pour chaque bloc de HASH_BLOCK octets suivi d'au moins un
+//    octet de la suite, puis hash_finish, donnent la même valeur que
+//    hash_bytes. Ces fonctions sont définies dans cet en-tête afin de pouvoir
+//    être intégrées aux boucles de lecture.
+
+#ifndef HASH__H
+#define HASH__H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+//  HASH_BLOCK : longueur des blocs d'octets traités par hash_step.
+#define HASH_BLOCK 16
+
+//  hash_seed : renvoie une graine obtenue à partir de sources qui varient d'une
+//    exécution à l'autre (horloge, adresses).
+extern uint64_t hash_seed(void);
+
+//  hash_bytes : renvoie la valeur de hachage, pour la graine seed, de la suite
+//    de n octets qui commence à l'adresse s.
+extern uint64_t hash_bytes(const void *s, size_t n, uint64_t seed);
+
+//  HASH__P0, HASH__P1 : constantes de mélange de wyhash.
+#define HASH__P0 0x2d358dccaa6c78a5ULL
+#define HASH__P1 0x8bb84b93962eacc9ULL
+
+//  hash__mum : remplace *a et *b par les moitiés basse et haute du produit sur
+//    128 bits de *a par *b.
+static inline void hash__mum(uint64_t *a, uint64_t *b) {
+#if defined __SIZEOF_INT128__
+  __extension__ typedef unsigned __int128 u128;
+  u128 r = (u128) *a * *b;
+  *a = (uint64_t) r;
+  *b = (uint64_t) (r >> 64);
+#else
+  uint64_t ha = *a >> 32;
+  uint64_t la = (uint32_t) *a;
+  uint64_t hb = *b >> 32;
+  uint64_t lb = (uint32_t) *b;
+  uint64_t rh = ha * hb;
+  uint64_t rm0 = ha * lb;
+  uint64_t rm1 = hb * la;
+  uint64_t rl = la * lb;
+  uint64_t t = rl + (rm0 << 32);
+  uint64_t c = t < rl;
+  uint64_t lo = t + (rm1 << 32);
+  c += lo < t;
+  *a = lo;
+  *b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+//  hash__mix : renvoie le ou exclusif des deux moitiés du produit sur 128 bits
+//    de a par b.
+static inline uint64_t hash__mix(uint64_t a, uint64_t b) {
+  hash__mum(&a, &b);
+  return a ^ b;
+}
+
+//  hash__r8, hash__r4 : renvoient les 8, 4 octets qui commencent à l'adresse p
+//    lus comme un entier.
+static inline uint64_t hash__r8(const unsigned char *p) {
+  uint64_t v;
+  memcpy(&v, p, sizeof v);
+  return v;
+}
+
+static inline uint64_t hash__r4(const unsigned char *p) {
+  uint32_t v;
+  memcpy(&v, p, sizeof v);
+  return v;
+}
+
+//  hash_start : renvoie l'état initial du calcul pour la graine seed.
+static inline uint64_t hash_start(uint64_t seed) {
+  return seed ^ hash__mix(seed ^ HASH__P0, HASH__P1);
+}
+
+//  hash_step : renvoie l'état obtenu en intégrant à l'état state le bloc de
+//    HASH_BLOCK octets qui commence à l'adresse p.
+static inline uint64_t hash_step(uint64_t state, const void *p) {
+  const unsigned char *q = p;
+  return hash__mix(hash__r8(q) ^ HASH__P1, hash__r8(q + 8) ^ state);
+}
+
+//  hash_finish : renvoie la valeur de hachage de la suite de n octets qui
+//    commence à l'adresse s, state étant l'état obtenu après intégration de
+//    ses blocs de HASH_BLOCK octets suivis d'au moins un octet. Seuls les
+//    HASH_BLOCK derniers octets sont lus si n est strictement supérieur à
+//    HASH_BLOCK.
+static inline uint64_t hash_finish(uint64_t state, const void *s, size_t n) {
+  const unsigned char *p = s;
+  uint64_t a;
+  uint64_t b;
+  if (n > HASH_BLOCK) {
+    a = hash__r8(p + n - 16);
+    b = hash__r8(p + n - 8);
+  } else if (n >= 4) {
+    a = (hash__r4(p) << 32) | hash__r4(p + ((n >> 3) << 2));
+    b = (hash__r4(p + n - 4) << 32) | hash__r4(p + n - 4 - ((n >> 3) << 2));
+  } else if (n > 0) {
+    a = ((uint64_t) p[0] << 16) | ((uint64_t) p[n >> 1] << 8) | p[n - 1];
+    b = 0;
+  } else {
+    a = 0;
+    b = 0;
+  }
+  a ^= HASH__P1;
+  b ^= state;
+  hash__mum(&a, &b);
+  return hash__mix(a ^ HASH__P0 ^ n, b ^ HASH__P1);
+}
+
+#endif
@@ -5,11 +5,17 @@
 #include <stdint.h>
 #include "hashtable.h"
 
+#if defined HASHTABLE_STATS && HASHTABLE_STATS != 0
+#include <time.h>
+#endif
+
 //  Le nombre de compartiments du tableau de hachage est une puissance de 2. Il
-//    vaut initialement « 2 ^ HT__LBNSLOTS_MIN ». Dès que le taux de remplissage
-//    de la table de hachage est strictement supérieur à
-//    « (double) HT__LDFACT_MAX_NUMER / (double) HT__LDFACT_MAX_DENOM », le
-//    nombre de compartiments est multiplié par 2.
+//    vaut initialement « 2 ^ HT__LBNSLOTS_MIN », à moins qu'une capacité plus
+//    grande n'ait été réservée. Dès que le taux de remplissage de la table de
+//    hachage est strictement supérieur au seuil, le nombre de compartiments est
+//    multiplié par 2. Le seuil vaut par défaut
+//    « (double) HT__LDFACT_MAX_NUMER / (double) HT__LDFACT_MAX_DENOM » ; il
+//    peut être modifié à l'exécution par hashtable_set_ldfact.
 
 #define HT__LBNSLOTS_MIN      6
 #define HT__LDFACT_MAX_NUMER  1
@@ -37,6 +43,38 @@
 #undef HT__NSLOTS_MIN
 #undef HT__NENTRIESMAX_MIN
 
+//  Si la macroconstante HASHTABLE_INCREMENTAL est définie et non nulle, la
+//    redistribution des cellules qui suit un agrandissement est étalée : chaque
+//    ajout migre au plus HT__MIGRATE_NSLOTS compartiments de l'ancien tableau
+//    vers le nouveau. Sinon, tous les compartiments sont migrés dès
+//    l'agrandissement. La valeur de HT__MIGRATE_NSLOTS doit garantir que la
+//    migration est achevée avant l'agrandissement suivant pour le seuil par
+//    défaut ; elle est augmentée à l'exécution si un seuil plus faible est
+//    choisi. L'agrandissement suivant achève néanmoins la migration si
+//    nécessaire.
+
+#if defined HASHTABLE_INCREMENTAL && HASHTABLE_INCREMENTAL != 0
+#define HT__MIGRATE_NSLOTS    4
+#else
+#define HT__MIGRATE_NSLOTS    SIZE_MAX
+#endif
+
+#if HT__MIGRATE_NSLOTS < 1                                                     \
+  || HT__MIGRATE_NSLOTS * HT__LDFACT_MAX_NUMER < HT__LDFACT_MAX_DENOM
+#error Bad choice of HT__MIGRATE_NSLOTS.
+#endif
+
+//  Les cellules sont allouées par blocs, les « slabs », dont le nombre de
+//    cellules vaut initialement HT__SLAB_NCELLS_MIN puis double d'un bloc à
+//    l'autre jusqu'à HT__SLAB_NCELLS_MAX.
+
+#define HT__SLAB_NCELLS_MIN   64
+#define HT__SLAB_NCELLS_MAX   65536
+
+#if HT__SLAB_NCELLS_MIN < 1 || HT__SLAB_NCELLS_MAX < HT__SLAB_NCELLS_MIN
+#error Bad choice of HT__SLAB_ constants.
+#endif
+
 //  struct hashtable, hashtable : gestion du chainage séparé par liste dynamique
 //    simplement chainée. Le composant compar mémorise la fonction de
 //    comparaison des clés, hashfun, leur fonction de pré-hachage. Le tableau de
@@ -51,19 +89,58 @@
 //    hasharray est l'adresse du champ null ; 2) la fonction de recherche locale
 //    hashtable__search est toujours définie car la valeur du champ null est
 //    NULL et la valeur de lbnslots est nulle si le tableau de hachage n'a pas
-//    été alloué.
+//    été alloué. Le seuil est le quotient des composants ldfactnumer et
+//    ldfactdenom ; le composant nmigrate mémorise le nombre de compartiments
+//    migrés à chaque ajout. Si HASHTABLE_STATS est définie et non nulle, le
+//    composant maxaddlat mémorise la durée maximale d'un ajout et les
+//    composants nprobes et nskips des compteurs de recherche.
+
+//  Les blocs de cellules forment une liste simplement chainée de tête slabs,
+//    le bloc de tête étant le dernier alloué. Les cellules de ce bloc sont
+//    distribuées dans l'ordre croissant de leurs adresses ; le composant
+//    slabfree mémorise le nombre de celles qui ne l'ont pas encore été. Les
+//    cellules retirées de la table forment une liste, chainée par leur
+//    composant next, de tête freecells ; elles sont réutilisées en priorité.
+//    La libération de la table ne parcourt donc que la liste des blocs.
 
 //  L'ajout d'une nouvelle entrée a lieu en queue de liste. L'ordre induit est
 //    respecté lors de tout agrandissement du tableau de hachage.
 
+//  Lors d'un agrandissement, le tableau de hachage courant devient l'ancien
+//    tableau, d'adresse oldarray, et un nouveau tableau de longueur double est
+//    alloué. Les compartiments de l'ancien tableau sont ensuite migrés dans
+//    l'ordre croissant de leurs indices ; nmigrated mémorise le nombre de
+//    compartiments déjà migrés. Le compartiment d'indice k_ de l'ancien tableau
+//    est réparti entre les compartiments d'indices k_ et k_ + HALF(m) du
+//    nouveau, où m est la longueur de ce dernier. Ces deux compartiments ne
+//    sont initialisés qu'à cette occasion. Une clé de valeur de pré-hachage h
+//    est donc cherchée dans le compartiment d'indice HASHVAL(h, lbnslots - 1)
+//    de l'ancien tableau si celui-ci n'a pas encore été migré, dans le
+//    compartiment d'indice HASHVAL(h, lbnslots) du nouveau sinon. La valeur de
+//    oldarray est NULL en dehors de toute migration.
+
+//  Chaque cellule mémorise dans le composant hashval la valeur de pré-hachage
+//    de sa clé. Elle permet de redistribuer les cellules lors d'un
+//    agrandissement sans appeler hashfun, et de n'appeler compar lors d'une
+//    recherche que sur les cellules dont la valeur de pré-hachage est égale à
+//    celle de la clé recherchée.
+
 typedef struct cell cell;
 
 struct cell {
-  const void *keyref;
-  const void *valref;
+  hashtable_entry entry;
+  size_t hashval;
   cell *next;
 };
 
+typedef struct slab slab;
+
+struct slab {
+  slab *next;
+  size_t ncells;
+  cell cells[];
+};
+
 struct hashtable {
   int (*compar)(const void *, const void *);
   size_t (*hashfun)(const void *);
@@ -71,12 +148,26 @@ struct hashtable {
   cell *null;
   size_t lbnslots;
   size_t nfreeentries;
+  size_t ldfactnumer;
+  size_t ldfactdenom;
+  size_t nmigrate;
+  cell **oldarray;
+  size_t nmigrated;
+  slab *slabs;
+  size_t slabfree;
+  cell *freecells;
+#if defined HASHTABLE_STATS && HASHTABLE_STATS != 0
+  double maxaddlat;
+  size_t nprobes;
+  size_t nskips;
+#endif
 };
 
 #define HT__MAKE_BLANK(ht)                                                     \
   (ht)->hasharray = &(ht)->null;                                               \
   (ht)->null = NULL;                                                           \
-  (ht)->lbnslots = 0
+  (ht)->lbnslots = 0;                                                          \
+  (ht)->oldarray = NULL
 
 #define HT__IS_BLANK(ht)                                                       \
   ((ht)->lbnslots == 0)
@@ -84,27 +175,98 @@ struct hashtable {
 #define HALF(k) ((k) >> 1)
 #define POW2(n) ((size_t) 1 << (n))
 
-#define HASHVAL(__hashfun, __lbnslots, __keyref)                               \
-  (__hashfun(__keyref) % POW2(__lbnslots))
+#define HASHVAL(__hashval, __lbnslots)                                         \
+  ((__hashval) % POW2(__lbnslots))
+
+#if defined __GNUC__
+#define HT__PREFETCH(p) __builtin_prefetch(p)
+#else
+#define HT__PREFETCH(p) ((void) (p))
+#endif
+
+#define HT__CAPACITY(ht, nslots)                                               \
+  ((nslots) / (ht)->ldfactdenom * (ht)->ldfactnumer)
+
+#define HT__NENTRIES(ht)                                                       \
+  (HT__IS_BLANK(ht)                                                            \
+  ? 0                                                                          \
+  : HT__CAPACITY(ht, POW2((ht)->lbnslots)) - (ht)->nfreeentries)
+
+//  hashtable__slot : renvoie l'adresse du compartiment de la table de hachage
+//    associée à ht dans lequel se trouve toute clé de valeur de pré-hachage h.
+static cell **hashtable__slot(const hashtable *ht, size_t h) {
+  if (ht->oldarray != NULL) {
+    size_t k_ = HASHVAL(h, ht->lbnslots - 1);
+    if (k_ >= ht->nmigrated) {
+      return &ht->oldarray[k_];
+    }
+  }
+  return &ht->hasharray[HASHVAL(h, ht->lbnslots)];
+}
 
 //  hashtable__search : recherche dans la table de hachage associé à ht une clé
-//    égale à keyref au sens de compar. Renvoie l'adresse du pointeur qui repère
-//    la cellule qui contient cette occurrence si elle existe. Renvoie sinon
-//    l'adresse du pointeur qui marque la fin de la liste.
-static cell **hashtable__search(const hashtable *ht, const void *keyref) {
-  size_t k = HASHVAL(ht->hashfun, ht->lbnslots, keyref);
-  cell * const *pp = &ht->hasharray[k];
-  while (*pp != NULL && ht->compar(keyref, (*pp)->keyref) != 0) {
+//    égale à keyref au sens de compar, dont la valeur de pré-hachage est h.
+//    Renvoie l'adresse du pointeur qui repère la cellule qui contient cette
+//    occurrence si elle existe. Renvoie sinon l'adresse du pointeur qui marque
+//    la fin de la liste. Si HASHTABLE_STATS est définie et non nulle, les
+//    composants nprobes et nskips comptent les cellules examinées et celles
+//    qui sont écartées sans appel à compar.
+static cell **hashtable__search(hashtable *ht, const void *keyref, size_t h) {
+  cell **pp = hashtable__slot(ht, h);
+  while (*pp != NULL) {
+#if defined HASHTABLE_STATS && HASHTABLE_STATS != 0
+    ht->nprobes += 1;
+    ht->nskips += (*pp)->hashval != h;
+#endif
+    if ((*pp)->hashval == h && ht->compar(keyref, (*pp)->entry.keyref) == 0) {
+      break;
+    }
     pp = &(*pp)->next;
   }
-  return (cell **) pp;
+  return pp;
+}
+
+//  hashtable__migrate : migre au plus n compartiments de l'ancien tableau de
+//    la table de hachage associée à ht, s'il existe, vers le nouveau. Libère
+//    l'ancien tableau une fois tous ses compartiments migrés.
+static void hashtable__migrate(hashtable *ht, size_t n) {
+  if (ht->oldarray == NULL) {
+    return;
+  }
+  size_t m_ = POW2(ht->lbnslots - 1);
+  while (n > 0 && ht->nmigrated < m_) {
+    size_t k_ = ht->nmigrated;
+    cell **pp_ = &ht->hasharray[k_];
+    cell **pp = &ht->hasharray[k_ + m_];
+    cell *p = ht->oldarray[k_];
+    while (p != NULL) {
+      if (HASHVAL(p->hashval, ht->lbnslots) < m_) {
+        *pp_ = p;
+        pp_ = &p->next;
+      } else {
+        *pp = p;
+        pp = &p->next;
+      }
+      p = p->next;
+    }
+    *pp_ = NULL;
+    *pp = NULL;
+    ht->nmigrated += 1;
+    n -= 1;
+  }
+  if (ht->nmigrated == m_) {
+    free(ht->oldarray);
+    ht->oldarray = NULL;
+  }
 }
 
 //  hashtable__add_enlarge : initialise ou agrandit le tableau de hachage de la
-//    table de hachage associée à ht. Il est supposé que la valeur de
-//    nfreeentries est nulle. Renvoie une valeur non nulle en cas de dépassement
-//    de capacité. Renvoie sinon zéro.
+//    table de hachage associée à ht, après avoir achevé la migration en cours
+//    s'il y a lieu. Il est supposé que la valeur de nfreeentries est nulle.
+//    Renvoie une valeur non nulle en cas de dépassement de capacité. Renvoie
+//    sinon zéro.
 static int hashtable__add_enlarge(hashtable *ht) {
+  hashtable__migrate(ht, SIZE_MAX);
   int b;
   size_t lbm;
   size_t m;
@@ -113,7 +275,6 @@ static int hashtable__add_enlarge(hashtable *ht) {
     lbm = HT__LBNSLOTS_MIN;
     m = POW2(lbm);
     m_ = 0;
-    ht->hasharray = NULL;
   } else {
     lbm = ht->lbnslots + 1;
     m = POW2(lbm);
@@ -121,13 +282,8 @@ static int hashtable__add_enlarge(hashtable *ht) {
   }
   cell **a;
   if (m > SIZE_MAX / sizeof *a
-      || (HT__LDFACT_MAX_NUMER > sizeof *a
-      && HT__LDFACT_MAX_NUMER > HT__LDFACT_MAX_DENOM
-      && m > SIZE_MAX / HT__LDFACT_MAX_NUMER * HT__LDFACT_MAX_DENOM)
-      || (a = realloc(ht->hasharray, m * sizeof *a)) == NULL) {
-    if (b) {
-      HT__MAKE_BLANK(ht);
-    }
+      || m / ht->ldfactdenom > SIZE_MAX / ht->ldfactnumer
+      || (a = malloc(m * sizeof *a)) == NULL) {
     return -1;
   }
   if (b) {
@@ -135,26 +291,51 @@ static int hashtable__add_enlarge(hashtable *ht) {
       a[k] = NULL;
     }
   } else {
+    ht->oldarray = ht->hasharray;
+    ht->nmigrated = 0;
+  }
+  ht->hasharray = a;
+  ht->lbnslots = lbm;
+  ht->nfreeentries = HT__CAPACITY(ht, m) - HT__CAPACITY(ht, m_);
+  return 0;
+}
+
+//  hashtable__resize : tente de remplacer le tableau de hachage de la table de
+//    hachage associée à ht, après avoir achevé la migration en cours s'il y a
+//    lieu, par un tableau de logarithme binaire de longueur lbm, supposé
+//    strictement supérieur à celui du tableau courant, et d'y redistribuer
+//    toutes les cellules. Renvoie une valeur non nulle en cas de dépassement
+//    de capacité. Renvoie sinon zéro.
+static int hashtable__resize(hashtable *ht, size_t lbm) {
+  hashtable__migrate(ht, SIZE_MAX);
+  size_t n = HT__NENTRIES(ht);
+  size_t m = POW2(lbm);
+  cell **a;
+  if (m > SIZE_MAX / sizeof *a
+      || m / ht->ldfactdenom > SIZE_MAX / ht->ldfactnumer
+      || (a = malloc(m * sizeof *a)) == NULL) {
+    return -1;
+  }
+  for (size_t k = 0; k < m; ++k) {
+    a[k] = NULL;
+  }
+  if (!HT__IS_BLANK(ht)) {
+    size_t m_ = POW2(ht->lbnslots);
     for (size_t k_ = 0; k_ < m_; ++k_) {
-      cell **pp_ = &a[k_];
-      cell **pp = &a[k_ + m_];
-      while (*pp_ != NULL) {
-        if (HASHVAL(ht->hashfun, lbm, (*pp_)->keyref) < m_) {
-          pp_ = &(*pp_)->next;
-        } else {
-          *pp = *pp_;
-          *pp_ = (*pp_)->next;
-          pp = &(*pp)->next;
-        }
+      cell *p = ht->hasharray[k_];
+      while (p != NULL) {
+        cell *t = p;
+        p = p->next;
+        cell **pp = &a[HASHVAL(t->hashval, lbm)];
+        t->next = *pp;
+        *pp = t;
       }
-      *pp = NULL;
     }
+    free(ht->hasharray);
   }
   ht->hasharray = a;
   ht->lbnslots = lbm;
-  ht->nfreeentries
-    = m / HT__LDFACT_MAX_DENOM * HT__LDFACT_MAX_NUMER
-      - m_ / HT__LDFACT_MAX_DENOM * HT__LDFACT_MAX_NUMER;
+  ht->nfreeentries = HT__CAPACITY(ht, m) - n;
   return 0;
 }
 
@@ -168,73 +349,250 @@ hashtable *hashtable_empty(int (*compar)(const void *, const void *),
   ht->hashfun = hashfun;
   HT__MAKE_BLANK(ht);
   ht->nfreeentries = 0;
+  ht->ldfactnumer = HT__LDFACT_MAX_NUMER;
+  ht->ldfactdenom = HT__LDFACT_MAX_DENOM;
+  ht->nmigrate = HT__MIGRATE_NSLOTS;
+  ht->slabs = NULL;
+  ht->slabfree = 0;
+  ht->freecells = NULL;
+#if defined HASHTABLE_STATS && HASHTABLE_STATS != 0
+  ht->maxaddlat = 0.0;
+  ht->nprobes = 0;
+  ht->nskips = 0;
+#endif
   return ht;
 }
 
+//  hashtable__cell_alloc : renvoie l'adresse d'une cellule inutilisée de la
+//    table de hachage associée à ht, prise dans la liste des cellules retirées
+//    si elle n'est pas vide, dans le bloc de tête sinon, un nouveau bloc étant
+//    alloué si celui-ci est épuisé. Renvoie NULL en cas de dépassement de
+//    capacité.
+static cell *hashtable__cell_alloc(hashtable *ht) {
+  if (ht->freecells != NULL) {
+    cell *p = ht->freecells;
+    ht->freecells = p->next;
+    return p;
+  }
+  if (ht->slabfree == 0) {
+    size_t n = HT__SLAB_NCELLS_MIN;
+    if (ht->slabs != NULL) {
+      n = ht->slabs->ncells < HT__SLAB_NCELLS_MAX / 2
+        ? 2 * ht->slabs->ncells
+        : HT__SLAB_NCELLS_MAX;
+    }
+    slab *s = malloc(sizeof *s + n * sizeof(cell));
+    if (s == NULL) {
+      return NULL;
+    }
+    s->next = ht->slabs;
+    s->ncells = n;
+    ht->slabs = s;
+    ht->slabfree = n;
+  }
+  cell *p = &ht->slabs->cells[ht->slabs->ncells - ht->slabfree];
+  ht->slabfree -= 1;
+  return p;
+}
+
+//  hashtable__cell_free : ajoute la cellule d'adresse p à la liste des cellules
+//    retirées de la table de hachage associée à ht.
+static void hashtable__cell_free(hashtable *ht, cell *p) {
+  p->next = ht->freecells;
+  ht->freecells = p;
+}
+
+int hashtable_set_ldfact(hashtable *ht, size_t numer, size_t denom) {
+  if (numer == 0 || denom == 0 || denom > POW2(HT__LBNSLOTS_MIN)
+      || HT__NENTRIES(ht) != 0) {
+    return -1;
+  }
+  ht->ldfactnumer = numer;
+  ht->ldfactdenom = denom;
+  size_t r = (denom + numer - 1) / numer;
+  ht->nmigrate = r > HT__MIGRATE_NSLOTS ? r : HT__MIGRATE_NSLOTS;
+  if (!HT__IS_BLANK(ht)) {
+    ht->nfreeentries = HT__CAPACITY(ht, POW2(ht->lbnslots));
+  }
+  return 0;
+}
+
+int hashtable_reserve(hashtable *ht, size_t n) {
+  size_t lbm = HT__LBNSLOTS_MIN;
+  while (HT__CAPACITY(ht, POW2(lbm)) < n) {
+    if (lbm >= sizeof(size_t) * 8 - 1) {
+      return -1;
+    }
+    ++lbm;
+  }
+  if (!HT__IS_BLANK(ht) && lbm <= ht->lbnslots) {
+    return 0;
+  }
+  return hashtable__resize(ht, lbm);
+}
+
 void hashtable_dispose(hashtable **htptr) {
   if (*htptr == NULL) {
     return;
   }
-  if (!HT__IS_BLANK(*htptr)) {
-    size_t m = POW2((*htptr)->lbnslots);
-    for (size_t k = 0; k < m; ++k) {
-      cell *p = (*htptr)->hasharray[k];
-      while (p != NULL) {
-        cell *t = p;
-        p = p->next;
-        free(t);
-      }
-    }
-    free((*htptr)->hasharray);
+  hashtable *ht = *htptr;
+  if (!HT__IS_BLANK(ht)) {
+    free(ht->oldarray);
+    free(ht->hasharray);
+  }
+  slab *s = ht->slabs;
+  while (s != NULL) {
+    slab *t = s;
+    s = s->next;
+    free(t);
   }
   free(*htptr);
   *htptr = NULL;
 }
 
-void *hashtable_add(hashtable *ht, const void *keyref, const void *valref) {
-  if (valref == NULL) {
-    return NULL;
-  }
-  cell **pp = hashtable__search(ht, keyref);
+#if defined HASHTABLE_STATS && HASHTABLE_STATS != 0
+
+//  hashtable__now : renvoie l'instant courant, en secondes.
+static double hashtable__now(void) {
+  struct timespec ts;
+  timespec_get(&ts, TIME_UTC);
+  return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+}
+
+#endif
+
+//  hashtable__find_or_insert : recherche dans la table de hachage associée à ht
+//    une clé égale à keyref au sens de compar, dont la valeur de pré-hachage
+//    est h. Si la recherche est positive,
+//    renvoie l'adresse de la cellule qui la contient. Tente sinon d'ajouter en
+//    queue de liste une cellule de clé keyref et de valeur NULL ; renvoie NULL
+//    en cas de dépassement de capacité ; renvoie sinon l'adresse de la cellule
+//    ajoutée. La liste n'est parcourue à nouveau qu'en cas d'agrandissement,
+//    et sans appel à compar puisque la clé est alors connue comme absente.
+//    Tout ajout est suivi de la migration d'au plus nmigrate compartiments ;
+//    si HASHTABLE_STATS est définie et non nulle, sa durée est mesurée et le
+//    composant maxaddlat mémorise la plus longue observée.
+static cell *hashtable__find_or_insert(hashtable *ht, const void *keyref,
+    size_t h) {
+#if defined HASHTABLE_STATS && HASHTABLE_STATS != 0
+  double t = hashtable__now();
+#endif
+  cell **pp = hashtable__search(ht, keyref, h);
   if (*pp != NULL) {
-    const void *r = (*pp)->valref;
-    (*pp)->valref = valref;
-    return (void *) r;
+    return *pp;
   }
   if (ht->nfreeentries == 0) {
     if (hashtable__add_enlarge(ht) != 0) {
       return NULL;
     }
-    pp = hashtable__search(ht, keyref);
+    pp = hashtable__slot(ht, h);
+    while (*pp != NULL) {
+      pp = &(*pp)->next;
+    }
   }
-  cell *p = malloc(sizeof *p);
+  cell *p = hashtable__cell_alloc(ht);
   if (p == NULL) {
     return NULL;
   }
-  p->keyref = keyref;
-  p->valref = valref;
-  p->next = *pp;
+  p->entry.keyref = keyref;
+  p->entry.valref = NULL;
+  p->hashval = h;
+  p->next = NULL;
   *pp = p;
   ht->nfreeentries -= 1;
-  return (void *) valref;
+  hashtable__migrate(ht, ht->nmigrate);
+#if defined HASHTABLE_STATS && HASHTABLE_STATS != 0
+  t = hashtable__now() - t;
+  if (t > ht->maxaddlat) {
+    ht->maxaddlat = t;
+  }
+#endif
+  return p;
+}
+
+void *hashtable_add(hashtable *ht, const void *keyref, const void *valref) {
+  if (valref == NULL) {
+    return NULL;
+  }
+  cell *p = hashtable__find_or_insert(ht, keyref, ht->hashfun(keyref));
+  if (p == NULL) {
+    return NULL;
+  }
+  const void *r = p->entry.valref;
+  p->entry.valref = valref;
+  return (void *) (r == NULL ? valref : r);
+}
+
+hashtable_entry *hashtable_find_or_insert(hashtable *ht, const void *keyref) {
+  return hashtable_find_or_insert_hashed(ht, keyref, ht->hashfun(keyref));
+}
+
+hashtable_entry *hashtable_find_or_insert_hashed(hashtable *ht,
+    const void *keyref, size_t h) {
+  cell *p = hashtable__find_or_insert(ht, keyref, h);
+  return p == NULL ? NULL : &p->entry;
+}
+
+//  hashtable__prefetch : demande le chargement anticipé en cache des
+//    compartiments de la table de hachage associée à ht dans lesquels se
+//    trouvent les clés de valeurs de pré-hachage hashes[0], ..., hashes[n - 1],
+//    puis celui des cellules de tête de ces compartiments. Tous les
+//    compartiments sont demandés avant que le premier ne soit lu.
+static void hashtable__prefetch(const hashtable *ht, size_t n,
+    const size_t *hashes) {
+  for (size_t k = 0; k < n; ++k) {
+    HT__PREFETCH(hashtable__slot(ht, hashes[k]));
+  }
+  for (size_t k = 0; k < n; ++k) {
+    const cell *p = *hashtable__slot(ht, hashes[k]);
+    if (p != NULL) {
+      HT__PREFETCH(p);
+    }
+  }
+}
+
+size_t hashtable_find_or_insert_batch(hashtable *ht, size_t n,
+    const void * const *keyrefs, const size_t *hashes,
+    hashtable_entry **entries) {
+  hashtable__prefetch(ht, n, hashes);
+  for (size_t k = 0; k < n; ++k) {
+    cell *p = hashtable__find_or_insert(ht, keyrefs[k], hashes[k]);
+    if (p == NULL) {
+      return k;
+    }
+    entries[k] = &p->entry;
+  }
+  return n;
 }
 
 void *hashtable_remove(hashtable *ht, const void *keyref) {
-  cell **pp = hashtable__search(ht, keyref);
+  cell **pp = hashtable__search(ht, keyref, ht->hashfun(keyref));
   if (*pp == NULL) {
     return NULL;
   }
   cell *p = *pp;
-  const void *r = p->valref;
+  const void *r = p->entry.valref;
   *pp = p->next;
-  free(p);
+  hashtable__cell_free(ht, p);
   ht->nfreeentries += 1;
   return (void *) r;
 }
 
 void *hashtable_search(hashtable *ht, const void *keyref) {
-  const cell *p = *hashtable__search(ht, keyref);
-  return p == NULL ? NULL : (void *) p->valref;
+  return hashtable_search_hashed(ht, keyref, ht->hashfun(keyref));
+}
+
+void *hashtable_search_hashed(hashtable *ht, const void *keyref, size_t h) {
+  const cell *p = *hashtable__search(ht, keyref, h);
+  return p == NULL ? NULL : (void *) p->entry.valref;
+}
+
+void hashtable_search_batch(hashtable *ht, size_t n,
+    const void * const *keyrefs, const size_t *hashes, void **valrefs) {
+  hashtable__prefetch(ht, n, hashes);
+  for (size_t k = 0; k < n; ++k) {
+    valrefs[k] = hashtable_search_hashed(ht, keyrefs[k], hashes[k]);
+  }
 }
 
 #if defined HASHTABLE_STATS && HASHTABLE_STATS != 0
@@ -242,12 +600,24 @@ void *hashtable_search(hashtable *ht, const void *keyref) {
 void hashtable_get_stats(hashtable *ht,
     struct hashtable_stats *htsptr) {
   size_t m = (HT__IS_BLANK(ht) ? 0 : POW2(ht->lbnslots));
-  size_t n = m / HT__LDFACT_MAX_DENOM * HT__LDFACT_MAX_NUMER - ht->nfreeentries;
+  size_t n = HT__NENTRIES(ht);
   size_t g = 0;
   double s = 0.0;
-  for (size_t k = 0; k < m; ++k) {
+  size_t m_ = (ht->oldarray == NULL ? 0 : HALF(m));
+  for (size_t k = 0; k < m + m_; ++k) {
+    const cell *p;
+    if (k >= m) {
+      if (k - m < ht->nmigrated) {
+        continue;
+      }
+      p = ht->oldarray[k - m];
+    } else if (ht->oldarray != NULL
+        && HASHVAL(k, ht->lbnslots - 1) >= ht->nmigrated) {
+      continue;
+    } else {
+      p = ht->hasharray[k];
+    }
     size_t f = 0;
-    const cell *p = ht->hasharray[k];
     while (p != NULL) {
       ++f;
       p = p->next;
@@ -261,11 +631,16 @@ void hashtable_get_stats(hashtable *ht,
   *htsptr = (struct hashtable_stats) {
     .nslots = m,
     .nentries = n,
-    .ldfactmax = (double) HT__LDFACT_MAX_NUMER / (double) HT__LDFACT_MAX_DENOM,
+    .ldfactmax = (double) ht->ldfactnumer / (double) ht->ldfactdenom,
     .ldfactcurr = r,
     .maxlen = g,
     .postheo = (n == 0 ? 0.0 : 1.0 + (r - 1.0 / (double) m) / 2.0),
     .poscurr = s / (double) n,
+    .maxaddlat = ht->maxaddlat,
+    .nprobes = ht->nprobes,
+    .nskips = ht->nskips,
+    .skiprate = (ht->nprobes == 0
+      ? 0.0 : (double) ht->nskips / (double) ht->nprobes),
   };
 }
 
@@ -284,7 +659,11 @@ int hashtable_fprint_stats(hashtable *ht, FILE *textstream) {
     || 0 > P_VALUE(textstream, "ld.fact.curr", "%lf", hts.ldfactcurr)
     || 0 > P_VALUE(textstream, "max.len", "%zu", hts.maxlen)
     || 0 > P_VALUE(textstream, "pos.theo", "%lf", hts.postheo)
-    || 0 > P_VALUE(textstream, "pos.curr", "%lf", hts.poscurr);
+    || 0 > P_VALUE(textstream, "pos.curr", "%lf", hts.poscurr)
+    || 0 > P_VALUE(textstream, "max.add.lat", "%lf", hts.maxaddlat)
+    || 0 > P_VALUE(textstream, "n.probes", "%zu", hts.nprobes)
+    || 0 > P_VALUE(textstream, "n.skips", "%zu", hts.nskips)
+    || 0 > P_VALUE(textstream, "skip.rate", "%lf", hts.skiprate);
 }
 
 #endif
@@ -4,8 +4,10 @@
 
 //  AUCUNE MODIFICATION DE CE SOURCE N'EST AUTORISÉE.
 
-//  Le comportement du module est sensible à la définition préalable de la
-//    macroconstante HASHTABLE_STATS.
+//  Le comportement du module est sensible à la définition préalable des
+//    macroconstantes HASHTABLE_STATS et HASHTABLE_INCREMENTAL. Si la seconde
+//    est définie et non nulle, la redistribution des entrées qui suit un
+//    agrandissement de la table est étalée sur les ajouts suivants.
 
 #ifndef HASHTABLE__H
 #define HASHTABLE__H
@@ -37,6 +39,15 @@
 //    valeurs quelconques.
 typedef struct hashtable hashtable;
 
+//  struct hashtable_entry, hashtable_entry : type et nom de type d'un couple
+//    de références de clé et de valeur stocké par une table de hachage.
+typedef struct hashtable_entry hashtable_entry;
+
+struct hashtable_entry {
+  const void *keyref;
+  const void *valref;
+};
+
 //  hashtable_empty :  tente d'allouer les ressources nécessaires pour gérer une
 //    nouvelle table de hachage initialement vide. La fonction de comparaison
 //    des clés via leurs références est pointée par compar et leur fonction de
@@ -45,6 +56,19 @@ typedef struct hashtable hashtable;
 extern hashtable *hashtable_empty(int (*compar)(const void *, const void *),
     size_t (*hashfun)(const void *));
 
+//  hashtable_set_ldfact : fixe à numer / denom le taux de remplissage maximum
+//    toléré par la table de hachage associée à ht, qui doit être vide. Renvoie
+//    une valeur non nulle si la table n'est pas vide, si numer ou denom est
+//    nul ou si denom est supérieur au nombre initial de compartiments ; le
+//    taux n'est alors pas modifié. Renvoie sinon zéro.
+extern int hashtable_set_ldfact(hashtable *ht, size_t numer, size_t denom);
+
+//  hashtable_reserve : tente d'agrandir la table de hachage associée à ht de
+//    sorte qu'elle puisse contenir n couples sans être agrandie à nouveau.
+//    Sans effet si c'est déjà le cas. Renvoie une valeur non nulle en cas de
+//    dépassement de capacité. Renvoie sinon zéro.
+extern int hashtable_reserve(hashtable *ht, size_t n);
+
 //  hashtable_dispose : sans effet si *htptr vaut NULL. Libère sinon les
 //    ressources allouées à la gestion de la table de hachage associée à *htptr
 //    puis affecte NULL à *htptr.
@@ -60,6 +84,43 @@ extern void hashtable_dispose(hashtable **htptr);
 extern void *hashtable_add(hashtable *ht, const void *keyref,
     const void *valref);
 
+//  hashtable_find_or_insert : recherche dans la table de hachage associée à ht
+//    la référence d'une clé égale à celle de référence keyref au sens de la
+//    fonction de comparaison. Si la recherche est positive, renvoie l'adresse
+//    du couple correspondant. Tente sinon d'ajouter le couple (keyref, NULL) à
+//    la table ; renvoie NULL en cas de dépassement de capacité ; renvoie sinon
+//    l'adresse du couple ajouté. Une seule recherche est effectuée dans les
+//    deux cas. Le composant valref du couple renvoyé vaut donc NULL si et
+//    seulement si le couple vient d'être ajouté : avant tout autre appel d'une
+//    fonction du module avec ht, il faut alors lui affecter une référence non
+//    nulle, la référence keyref pouvant aussi être remplacée par celle d'une
+//    clé égale, ou bien retirer le couple avec hashtable_remove. L'adresse
+//    renvoyée reste valide jusqu'au retrait du couple.
+extern hashtable_entry *hashtable_find_or_insert(hashtable *ht,
+    const void *keyref);
+
+//  hashtable_find_or_insert_hashed : comme hashtable_find_or_insert, h étant
+//    la valeur de pré-hachage de la clé de référence keyref, supposée égale à
+//    celle que renverrait la fonction de pré-hachage, qui n'est alors pas
+//    appelée.
+extern hashtable_entry *hashtable_find_or_insert_hashed(hashtable *ht,
+    const void *keyref, size_t h);
+
+//  hashtable_find_or_insert_batch : applique hashtable_find_or_insert_hashed
+//    successivement aux couples (keyrefs[k], hashes[k]), pour k allant de 0 à
+//    n - 1, et affecte l'adresse renvoyée à entries[k]. Les compartiments
+//    concernés sont auparavant tous demandés en cache. S'arrête au premier
+//    dépassement de capacité. Renvoie le nombre de couples traités avec
+//    succès. Une clé présente plusieurs fois dans keyrefs est ajoutée au plus
+//    une fois : les adresses renvoyées pour ses occurrences suivantes sont
+//    celle renvoyée pour la première. Il faut donc traiter les couples
+//    renvoyés dans l'ordre, en affectant une référence non nulle au composant
+//    valref de chaque couple ajouté avant de passer aux suivants. Les clés de
+//    références keyrefs[k] doivent rester valides jusque là.
+extern size_t hashtable_find_or_insert_batch(hashtable *ht, size_t n,
+    const void * const *keyrefs, const size_t *hashes,
+    hashtable_entry **entries);
+
 //  hashtable_remove : recherche dans la table de hachage associée à ht la
 //    référence d'une clé égale à celle de référence keyref au sens de la
 //    fonction de comparaison. Si la recherche est négative, renvoie NULL.
@@ -74,6 +135,19 @@ extern void *hashtable_remove(hashtable *ht, const void *keyref);
 //    référence de la valeur correspondante sinon.
 extern void *hashtable_search(hashtable *ht, const void *keyref);
 
+//  hashtable_search_hashed : comme hashtable_search, h étant la valeur de
+//    pré-hachage de la clé de référence keyref, supposée égale à celle que
+//    renverrait la fonction de pré-hachage, qui n'est alors pas appelée.
+extern void *hashtable_search_hashed(hashtable *ht, const void *keyref,
+    size_t h);
+
+//  hashtable_search_batch : affecte à valrefs[k], pour k allant de 0 à n - 1,
+//    la valeur renvoyée par hashtable_search_hashed pour keyrefs[k] et
+//    hashes[k]. Les compartiments concernés sont auparavant tous demandés en
+//    cache, ce qui recouvre les temps d'accès à la mémoire des n recherches.
+extern void hashtable_search_batch(hashtable *ht, size_t n,
+    const void * const *keyrefs, const size_t *hashes, void **valrefs);
+
 #if defined HASHTABLE_STATS && HASHTABLE_STATS != 0
 
 #include <stdio.h>
@@ -90,6 +164,12 @@ struct hashtable_stats {
                       //    d'une recherche positive
   double poscurr;     //  nombre moyen courant de comparaisons dans le cas d'une
                       //    recherche positive
+  double maxaddlat;   //  durée maximale d'un ajout, en secondes
+  size_t nprobes;     //  nombre de clés examinées lors des recherches
+  size_t nskips;      //  nombre de clés examinées écartées par comparaison des
+                      //    valeurs de pré-hachage, sans appel à la fonction de
+                      //    comparaison
+  double skiprate;    //  proportion de clés examinées écartées de la sorte
 };
 
 //  hashtable_get_stats : effectue un bilan de santé pour la table de hachage
@@ -1,14 +1,407 @@
 //  Partie implantation du module holdall.
 
+#include <stdint.h>
 #include "holdall.h"
 
-//  struct holdall, holdall : implantation par liste dynamique simplement
-//    chainée.
+//  Si la macroconstante HOLDALL_CHUNKED est définie et que sa macro-évaluation
+//    donne un entier non nul, struct holdall est implantée par un tableau
+//    dynamique de blocs de références. Dans le cas contraire, elle est
+//    implantée par une liste dynamique simplement chainée.
 
 //  Si la macroconstante HOLDALL_PUT_TAIL est définie et que sa macro-évaluation
 //    donne un entier non nul, l'insertion dans la liste a lieu en queue. Dans
 //    le cas contraire, elle a lieu en tête.
 
+#if defined HOLDALL_WANT_EXT && HOLDALL_WANT_EXT != 0
+
+#define HALF(k) ((k) >> 1)
+
+//  Quelle que soit l'implantation, le tri recopie les références dans un
+//    tableau contigu, le trie par fusion ascendante puis les replace dans la
+//    structure en une seule passe. Les segments de HOLDALL__RUN_LEN
+//    références sont d'abord triés par insertion puis fusionnés deux à deux
+//    en alternant entre le tableau et un espace de travail de même longueur.
+//    Deux segments consécutifs déjà ordonnés sont recopiés sans être
+//    fusionnés. Le tri est stable.
+
+#define HOLDALL__RUN_LEN 16
+
+//  holdall__isort : trie de manière stable par insertion le tableau de
+//    longueur n pointé par a selon la fonction compar.
+static void holdall__isort(void **a, size_t n,
+    int (*compar)(const void *, const void *)) {
+  for (size_t k = 1; k < n; ++k) {
+    void *ref = a[k];
+    size_t j = k;
+    while (j > 0 && compar(a[j - 1], ref) > 0) {
+      a[j] = a[j - 1];
+      --j;
+    }
+    a[j] = ref;
+  }
+}
+
+//  holdall__merge : fusionne selon la fonction compar les tableaux triés
+//    a[0 .. m - 1] et a[m .. n - 1] dans le tableau pointé par t. Les éléments
+//    de a[0 .. m - 1] précèdent ceux qui leur sont égaux dans a[m .. n - 1].
+static void holdall__merge(void **a, void **t, size_t m, size_t n,
+    int (*compar)(const void *, const void *)) {
+  size_t i = 0;
+  size_t j = m;
+  size_t k = 0;
+  if (m < n && compar(a[m - 1], a[m]) > 0) {
+    while (i < m && j < n) {
+      if (compar(a[i], a[j]) <= 0) {
+        t[k] = a[i];
+        ++i;
+      } else {
+        t[k] = a[j];
+        ++j;
+      }
+      ++k;
+    }
+  }
+  while (i < m) {
+    t[k] = a[i];
+    ++i;
+    ++k;
+  }
+  while (j < n) {
+    t[k] = a[j];
+    ++j;
+    ++k;
+  }
+}
+
+//  holdall__msort : trie de manière stable selon la fonction compar les
+//    références du tableau de longueur n pointé par a, en se servant du
+//    tableau de même longueur pointé par t comme espace de travail. Renvoie
+//    l'adresse de celui des deux tableaux qui contient le résultat.
+static void **holdall__msort(void **a, void **t, size_t n,
+    int (*compar)(const void *, const void *)) {
+  for (size_t k = 0; k < n; k += HOLDALL__RUN_LEN) {
+    holdall__isort(a + k, n - k < HOLDALL__RUN_LEN ? n - k : HOLDALL__RUN_LEN,
+        compar);
+  }
+  for (size_t w = HOLDALL__RUN_LEN; w < n; w *= 2) {
+    for (size_t k = 0; k < n; k += 2 * w) {
+      size_t len = n - k < 2 * w ? n - k : 2 * w;
+      holdall__merge(a + k, t + k, len < w ? len : w, len, compar);
+    }
+    void **x = a;
+    a = t;
+    t = x;
+  }
+  return a;
+}
+
+//  holdall__sort_alloc : tente d'allouer un tableau de longueur 2 * n
+//    destiné au tri de n références. Renvoie NULL en cas de dépassement de
+//    capacité. Renvoie sinon l'adresse du tableau.
+static void **holdall__sort_alloc(size_t n) {
+  if (n > SIZE_MAX / sizeof(void *) / 2) {
+    return NULL;
+  }
+  return malloc(2 * n * sizeof(void *));
+}
+
+#endif
+
+#if defined HOLDALL_CHUNKED && HOLDALL_CHUNKED != 0
+
+//  struct holdall, holdall : implantation par tableau dynamique de blocs. Les
+//    références sont rangées dans l'ordre des insertions dans des blocs de
+//    HOLDALL__CHUNK_LEN références, alloués au fur et à mesure des besoins et
+//    jamais déplacés. Seul le tableau des adresses des blocs est réalloué,
+//    sa capacité étant alors doublée. Une insertion ne donne ainsi lieu à une
+//    allocation qu'une fois tous les HOLDALL__CHUNK_LEN appels et les parcours
+//    lisent les références de manière séquentielle.
+//  L'insertion en tête est simulée en parcourant les références dans l'ordre
+//    inverse de celui des insertions.
+
+#define HOLDALL__LBCHUNK_LEN  10
+#define HOLDALL__CHUNK_LEN    ((size_t) 1 << HOLDALL__LBCHUNK_LEN)
+#define HOLDALL__NCHUNKS_MIN  8
+
+//  HOLDALL__PREFETCH_DIST : nombre de références séparant, lors d'un parcours,
+//    la référence courante de celle dont l'objet repéré est demandé par
+//    anticipation en cache.
+#define HOLDALL__PREFETCH_DIST 8
+
+#if defined __GNUC__
+#define HOLDALL__PREFETCH(p) __builtin_prefetch(p)
+#else
+#define HOLDALL__PREFETCH(p) ((void) (p))
+#endif
+
+struct holdall {
+  void ***chunks;
+  size_t nchunks;
+  size_t capchunks;
+  size_t count;
+};
+
+//  HOLDALL__SLOT : désigne l'emplacement de la k-ème référence insérée dans le
+//    fourretout associé à ha.
+#define HOLDALL__SLOT(ha, k)                                                   \
+  ((ha)->chunks[(k) >> HOLDALL__LBCHUNK_LEN][(k) & (HOLDALL__CHUNK_LEN - 1)])
+
+//  HOLDALL__REF : désigne l'emplacement de la k-ème référence du fourretout
+//    associé à ha selon l'ordre dans lequel les références y figurent.
+#if defined HOLDALL_PUT_TAIL && HOLDALL_PUT_TAIL != 0
+#define HOLDALL__REF(ha, k) HOLDALL__SLOT(ha, k)
+#else
+#define HOLDALL__REF(ha, k) HOLDALL__SLOT(ha, (ha)->count - 1 - (k))
+#endif
+
+//  HOLDALL__PREFETCH_NEXT : demande le chargement anticipé en cache de l'objet
+//    repéré par la référence qui suit de HOLDALL__PREFETCH_DIST la k-ème
+//    référence du fourretout associé à ha, si elle existe.
+#define HOLDALL__PREFETCH_NEXT(ha, k)                                          \
+  if ((k) + HOLDALL__PREFETCH_DIST < (ha)->count) {                            \
+    HOLDALL__PREFETCH(HOLDALL__REF(ha, (k) + HOLDALL__PREFETCH_DIST));         \
+  }
+
+holdall *holdall_empty(void) {
+  holdall *ha = malloc(sizeof *ha);
+  if (ha == NULL) {
+    return NULL;
+  }
+  ha->chunks = NULL;
+  ha->nchunks = 0;
+  ha->capchunks = 0;
+  ha->count = 0;
+  return ha;
+}
+
+void holdall_dispose(holdall **haptr) {
+  if (*haptr == NULL) {
+    return;
+  }
+  for (size_t k = 0; k < (*haptr)->nchunks; ++k) {
+    free((*haptr)->chunks[k]);
+  }
+  free((*haptr)->chunks);
+  free(*haptr);
+  *haptr = NULL;
+}
+
+//  holdall__add_chunk : tente d'ajouter un bloc au fourretout associé à ha, en
+//    doublant au besoin la capacité du tableau des adresses des blocs. Renvoie
+//    une valeur non nulle en cas de dépassement de capacité. Renvoie sinon
+//    zéro.
+static int holdall__add_chunk(holdall *ha) {
+  if (ha->nchunks == ha->capchunks) {
+    size_t cap = ha->capchunks == 0 ? HOLDALL__NCHUNKS_MIN : 2 * ha->capchunks;
+    if (cap > SIZE_MAX / sizeof *ha->chunks) {
+      return -1;
+    }
+    void ***a = realloc(ha->chunks, cap * sizeof *a);
+    if (a == NULL) {
+      return -1;
+    }
+    ha->chunks = a;
+    ha->capchunks = cap;
+  }
+  void **c = malloc(HOLDALL__CHUNK_LEN * sizeof *c);
+  if (c == NULL) {
+    return -1;
+  }
+  ha->chunks[ha->nchunks] = c;
+  ha->nchunks += 1;
+  return 0;
+}
+
+int holdall_put(holdall *ha, void *ref) {
+  if (ha->count == ha->nchunks * HOLDALL__CHUNK_LEN
+      && holdall__add_chunk(ha) != 0) {
+    return -1;
+  }
+  HOLDALL__SLOT(ha, ha->count) = ref;
+  ha->count += 1;
+  return 0;
+}
+
+size_t holdall_count(holdall *ha) {
+  return ha->count;
+}
+
+int holdall_apply(holdall *ha,
+    int (*fun)(void *)) {
+  for (size_t k = 0; k < ha->count; ++k) {
+    HOLDALL__PREFETCH_NEXT(ha, k)
+    int r = fun(HOLDALL__REF(ha, k));
+    if (r != 0) {
+      return r;
+    }
+  }
+  return 0;
+}
+
+int holdall_apply_context(holdall *ha,
+    void *context, void *(*fun1)(void *context, void *ptr),
+    int (*fun2)(void *ptr, void *resultfun1)) {
+  for (size_t k = 0; k < ha->count; ++k) {
+    HOLDALL__PREFETCH_NEXT(ha, k)
+    void *ref = HOLDALL__REF(ha, k);
+    int r = fun2(ref, fun1(context, ref));
+    if (r != 0) {
+      return r;
+    }
+  }
+  return 0;
+}
+
+int holdall_apply_context2(holdall *ha,
+    void *context1, void *(*fun1)(void *context1, void *ptr),
+    void *context2, int (*fun2)(void *context2, void *ptr, void *resultfun1)) {
+  for (size_t k = 0; k < ha->count; ++k) {
+    HOLDALL__PREFETCH_NEXT(ha, k)
+    void *ref = HOLDALL__REF(ha, k);
+    int r = fun2(context2, ref, fun1(context1, ref));
+    if (r != 0) {
+      return r;
+    }
+  }
+  return 0;
+}
+
+#if defined HOLDALL_WANT_EXT && HOLDALL_WANT_EXT != 0
+
+//  holdall__swap : échange les i-ème et j-ème références du fourretout associé
+//    à ha.
+static void holdall__swap(holdall *ha, size_t i, size_t j) {
+  void *ref = HOLDALL__REF(ha, i);
+  HOLDALL__REF(ha, i) = HOLDALL__REF(ha, j);
+  HOLDALL__REF(ha, j) = ref;
+}
+
+//  holdall__rotate : échange, dans le fourretout associé à ha, la suite des
+//    références d'indices first à middle - 1 avec celle des références
+//    d'indices middle à last - 1, par trois retournements. Renvoie l'indice
+//    auquel se trouve ensuite la référence qui était d'indice first.
+static size_t holdall__rotate(holdall *ha, size_t first, size_t middle,
+    size_t last) {
+  for (size_t i = first, j = middle; i + 1 < j; ++i, --j) {
+    holdall__swap(ha, i, j - 1);
+  }
+  for (size_t i = middle, j = last; i + 1 < j; ++i, --j) {
+    holdall__swap(ha, i, j - 1);
+  }
+  for (size_t i = first, j = last; i + 1 < j; ++i, --j) {
+    holdall__swap(ha, i, j - 1);
+  }
+  return first + (last - middle);
+}
+
+//  holdall__merge_inplace : fusionne de manière stable selon la fonction
+//    compar, sans allocation, les suites triées des références d'indices
+//    first à middle - 1 et middle à last - 1 du fourretout associé à ha. La
+//    plus longue des deux suites est coupée en son milieu, l'autre à la
+//    position correspondante trouvée par dichotomie, puis les deux parties
+//    centrales sont échangées par rotation et chaque moitié est fusionnée à
+//    son tour.
+static void holdall__merge_inplace(holdall *ha, size_t first, size_t middle,
+    size_t last, int (*compar)(const void *, const void *)) {
+  while (first < middle && middle < last) {
+    if (last - first == 2) {
+      if (compar(HOLDALL__REF(ha, middle), HOLDALL__REF(ha, first)) < 0) {
+        holdall__swap(ha, first, middle);
+      }
+      return;
+    }
+    size_t cut1;
+    size_t cut2;
+    if (middle - first > last - middle) {
+      cut1 = first + HALF(middle - first);
+      size_t lo = middle;
+      size_t hi = last;
+      while (lo < hi) {
+        size_t mid = lo + HALF(hi - lo);
+        if (compar(HOLDALL__REF(ha, mid), HOLDALL__REF(ha, cut1)) < 0) {
+          lo = mid + 1;
+        } else {
+          hi = mid;
+        }
+      }
+      cut2 = lo;
+    } else {
+      cut2 = middle + HALF(last - middle);
+      size_t lo = first;
+      size_t hi = middle;
+      while (lo < hi) {
+        size_t mid = lo + HALF(hi - lo);
+        if (compar(HOLDALL__REF(ha, cut2), HOLDALL__REF(ha, mid)) < 0) {
+          hi = mid;
+        } else {
+          lo = mid + 1;
+        }
+      }
+      cut1 = lo;
+    }
+    size_t m = holdall__rotate(ha, cut1, middle, cut2);
+    holdall__merge_inplace(ha, first, cut1, m, compar);
+    first = m;
+    middle = cut2;
+  }
+}
+
+//  holdall__sort_inplace : trie de manière stable, sans allocation, le
+//    fourretout associé à ha selon la fonction compar : les segments de
+//    HOLDALL__RUN_LEN références sont triés par insertion puis fusionnés sur
+//    place deux à deux.
+static void holdall__sort_inplace(holdall *ha,
+    int (*compar)(const void *, const void *)) {
+  size_t n = ha->count;
+  for (size_t k = 1; k < n; ++k) {
+    size_t lo = k - k % HOLDALL__RUN_LEN;
+    void *ref = HOLDALL__REF(ha, k);
+    size_t j = k;
+    while (j > lo && compar(HOLDALL__REF(ha, j - 1), ref) > 0) {
+      HOLDALL__REF(ha, j) = HOLDALL__REF(ha, j - 1);
+      --j;
+    }
+    HOLDALL__REF(ha, j) = ref;
+  }
+  for (size_t w = HOLDALL__RUN_LEN; w < n; w *= 2) {
+    for (size_t k = 0; k + w < n; k += 2 * w) {
+      size_t last = n - k - w < w ? n : k + 2 * w;
+      holdall__merge_inplace(ha, k, k + w, last, compar);
+    }
+  }
+}
+
+//  Si l'allocation du tableau et de l'espace de travail échoue, le tri a lieu
+//    sur place dans les blocs, par holdall__sort_inplace.
+
+void holdall_sort(holdall *ha,
+    int (*compar)(const void *, const void *)) {
+  size_t n = ha->count;
+  if (n <= 1) {
+    return;
+  }
+  void **a = holdall__sort_alloc(n);
+  if (a == NULL) {
+    holdall__sort_inplace(ha, compar);
+    return;
+  }
+  for (size_t k = 0; k < n; ++k) {
+    a[k] = HOLDALL__REF(ha, k);
+  }
+  void **r = holdall__msort(a, a + n, n, compar);
+  for (size_t k = 0; k < n; ++k) {
+    HOLDALL__REF(ha, k) = r[k];
+  }
+  free(a);
+}
+
+#endif
+
+#else
+
+//  struct holdall, holdall : implantation par liste dynamique simplement
+//    chainée.
+
 typedef struct choldall choldall;
 
 struct choldall {
@@ -110,73 +503,92 @@ int holdall_apply_context2(holdall *ha,
 
 #if defined HOLDALL_WANT_EXT && HOLDALL_WANT_EXT != 0
 
-#define HALF(k) ((k) >> 1)
-
-//  partage : Coupe la liste pointée par ha en deux listes de longueur
-//    équivalente (±1) et renvoie un pointeur vers la premiére cellule de la
-//    deuxiéme liste.
-static choldall *partage(holdall *ha) {
-  size_t n = HALF(ha->count);
-  choldall **pp = &ha->head;
-  for (size_t k = 0; k < n; ++k) {
-    pp = &(*pp)->next;
-  }
-  choldall *p = *pp;
-  *pp = NULL;
-  return p;
-}
-
 //  fuse : fusionne dans la liste pointée par *pp les deux listes pointées par
-//    h1 et h2
+//    h1 et h2.
 static void fuse(choldall **pp, choldall *h1, choldall *h2,
     int (*compar)(const void *, const void *)) {
-  choldall *p = NULL;
-  choldall **pp2 = &p;
   while (h1 != NULL && h2 != NULL) {
     if (compar(h1->ref, h2->ref) <= 0) {
-      choldall *p1 = h1->next;
-      *pp2 = h1;
-      pp2 = &h1->next;
-      h1 = p1;
+      *pp = h1;
+      pp = &h1->next;
+      h1 = h1->next;
     } else {
-      choldall *p2 = h2->next;
-      *pp2 = h2;
-      pp2 = &h2->next;
-      h2 = p2;
+      *pp = h2;
+      pp = &h2->next;
+      h2 = h2->next;
+    }
+  }
+  *pp = h1 != NULL ? h1 : h2;
+}
+
+//  HOLDALL__NLISTS : nombre de listes intermédiaires du tri sans allocation.
+//    La i-ème liste intermédiaire est vide ou de longueur 2 ^ i, sauf la
+//    dernière, qui peut être plus longue.
+#define HOLDALL__NLISTS 64
+
+//  holdall__lsort : trie de manière stable selon la fonction compar le
+//    fourretout associé à ha, en fusionnant ses cellules deux à deux par
+//    longueurs croissantes, sans allocation.
+static void holdall__lsort(holdall *ha,
+    int (*compar)(const void *, const void *)) {
+  choldall *lists[HOLDALL__NLISTS] = {
+    NULL
+  };
+  choldall *p = ha->head;
+  while (p != NULL) {
+    choldall *h = p;
+    p = p->next;
+    h->next = NULL;
+    size_t i = 0;
+    while (i < HOLDALL__NLISTS - 1 && lists[i] != NULL) {
+      fuse(&h, lists[i], h, compar);
+      lists[i] = NULL;
+      ++i;
     }
+    fuse(&lists[i], lists[i], h, compar);
   }
-  *pp = p;
-  if (h1 != NULL) {
-    *pp2 = h1;
+  ha->head = NULL;
+  for (size_t i = 0; i < HOLDALL__NLISTS; ++i) {
+    fuse(&ha->head, lists[i], ha->head, compar);
   }
-  if (h2 != NULL) {
-    *pp2 = h2;
+#if defined HOLDALL_PUT_TAIL && HOLDALL_PUT_TAIL != 0
+  ha->tailptr = &ha->head;
+  while (*ha->tailptr != NULL) {
+    ha->tailptr = &(*ha->tailptr)->next;
   }
+#endif
 }
 
+//  Les cellules restent en place : seules leurs références sont remplacées
+//    par celles du tableau trié. Si l'allocation du tableau et de l'espace de
+//    travail échoue, les cellules sont triées sur place par
+//    holdall__lsort.
+
 void holdall_sort(holdall *ha,
     int (*compar)(const void *, const void *)) {
-  if (ha->count <= 1) {
+  size_t n = ha->count;
+  if (n <= 1) {
     return;
   }
-  size_t n = ha->count;
-  holdall ha2 = {
-    partage(ha),
-    .count = ha->count - HALF(ha->count)
-  };
-  ha->count = HALF(ha->count);
-  holdall_sort(&ha2, compar);
-  holdall_sort(ha, compar);
-  choldall *p = NULL;
-  fuse(&p, ha->head, ha2.head, compar);
-  ha->head = p;
-#if defined HOLDALL_PUT_TAIL && HOLDALL_PUT_TAIL != 0
-  while (p->next != NULL) {
-    p = p->next;
+  void **a = holdall__sort_alloc(n);
+  if (a == NULL) {
+    holdall__lsort(ha, compar);
+    return;
   }
-  ha->tailptr = &p;
-#endif
-  ha->count = n;
+  size_t k = 0;
+  for (const choldall *p = ha->head; p != NULL; p = p->next) {
+    a[k] = p->ref;
+    ++k;
+  }
+  void **r = holdall__msort(a, a + n, n, compar);
+  k = 0;
+  for (choldall *p = ha->head; p != NULL; p = p->next) {
+    p->ref = r[k];
+    ++k;
+  }
+  free(a);
 }
 
 #endif
+
+#endif
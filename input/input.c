@@ -0,0 +1,129 @@
+//  Partie implantation du module input.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "input.h"
+#include <stdbool.h>
+#include <errno.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+//  INPUT__BUFSIZE : taille du tampon utilisé lorsque le fichier ne peut pas
+//    être projeté en mémoire.
+#define INPUT__BUFSIZE 65536
+
+//  struct input, input : le composant fd mémorise le descripteur du fichier et
+//    is_stdin indique s'il s'agit de l'entrée standard. Si le fichier est
+//    projeté en mémoire, map et mapsize mémorisent l'adresse et la longueur de
+//    la projection et mapread indique si celle-ci a déjà été renvoyée par
+//    input_read ; buf vaut alors NULL. Sinon, map vaut NULL et buf est
+//    l'adresse du tampon de lecture.
+struct input {
+  int fd;
+  bool is_stdin;
+  char *map;
+  size_t mapsize;
+  bool mapread;
+  char *buf;
+};
+
+//  input__map : tente de projeter en mémoire le fichier associé à in s'il
+//    s'agit d'un fichier régulier non vide. Renvoie zéro en cas de succès, une
+//    valeur non nulle sinon.
+static int input__map(input *in) {
+  struct stat st;
+  if (fstat(in->fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0
+      || (uintmax_t) st.st_size > SIZE_MAX) {
+    return -1;
+  }
+  void *m = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, in->fd, 0);
+  if (m == MAP_FAILED) {
+    return -1;
+  }
+  posix_madvise(m, (size_t) st.st_size, POSIX_MADV_SEQUENTIAL);
+  in->map = m;
+  in->mapsize = (size_t) st.st_size;
+  return 0;
+}
+
+input *input_open(const char *filename) {
+  input *in = malloc(sizeof *in);
+  if (in == NULL) {
+    return NULL;
+  }
+  in->is_stdin = filename == NULL;
+  in->fd = in->is_stdin ? STDIN_FILENO : open(filename, O_RDONLY);
+  if (in->fd < 0) {
+    free(in);
+    return NULL;
+  }
+  in->map = NULL;
+  in->mapsize = 0;
+  in->mapread = false;
+  in->buf = NULL;
+  if (in->is_stdin || input__map(in) != 0) {
+    in->buf = malloc(INPUT__BUFSIZE);
+    if (in->buf == NULL) {
+      if (!in->is_stdin) {
+        close(in->fd);
+      }
+      free(in);
+      return NULL;
+    }
+  }
+  return in;
+}
+
+size_t input_filesize(const char *filename) {
+  struct stat st;
+  if (stat(filename, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0
+      || (uintmax_t) st.st_size > SIZE_MAX) {
+    return 0;
+  }
+  return (size_t) st.st_size;
+}
+
+int input_read(input *in, const char **sptr, size_t *nptr) {
+  if (in->map != NULL) {
+    if (in->mapread) {
+      return 0;
+    }
+    in->mapread = true;
+    *sptr = in->map;
+    *nptr = in->mapsize;
+    return 1;
+  }
+  ssize_t n;
+  do {
+    n = read(in->fd, in->buf, INPUT__BUFSIZE);
+  } while (n < 0 && errno == EINTR);
+  if (n <= 0) {
+    return n < 0 ? -1 : 0;
+  }
+  *sptr = in->buf;
+  *nptr = (size_t) n;
+  return 1;
+}
+
+int input_close(input **inptr) {
+  if (*inptr == NULL) {
+    return 0;
+  }
+  input *in = *inptr;
+  int r = 0;
+  if (in->map != NULL) {
+    munmap(in->map, in->mapsize);
+  }
+  free(in->buf);
+  if (in->is_stdin) {
+    lseek(in->fd, 0, SEEK_SET);
+  } else {
+    r = close(in->fd);
+  }
+  free(in);
+  *inptr = NULL;
+  return r;
+}
@@ -0,0 +1,42 @@
+//  input : Un module permettant de lire le contenu d'un fichier par blocs
+//    d'octets contigus, mémorisé dans une structure nommée « input ». Les
+//    fichiers réguliers sont projetés en mémoire en un seul bloc. Les autres
+//    fichiers (tubes, terminaux, entrée standard) sont lus par appels à read
+//    dans un tampon interne.
+
+#ifndef INPUT__H
+#define INPUT__H
+
+#include <stdlib.h>
+
+//  struct input, input : type et nom de type d'un contrôleur regroupant les
+//    informations nécessaires pour lire un fichier par blocs.
+typedef struct input input;
+
+//  input_open : tente d'ouvrir en lecture le fichier de nom filename, ou
+//    l'entrée standard si filename vaut NULL, et d'allouer les ressources
+//    nécessaires à sa lecture. Renvoie NULL en cas d'échec. Renvoie sinon un
+//    pointeur vers le contrôleur associé au fichier.
+extern input *input_open(const char *filename);
+
+//  input_filesize : renvoie la taille en octets du fichier de nom filename s'il
+//    s'agit d'un fichier régulier dont la taille peut être obtenue. Renvoie
+//    sinon zéro.
+extern size_t input_filesize(const char *filename);
+
+//  input_read : tente de lire le bloc suivant du fichier associé à in. Renvoie
+//    une valeur strictement négative en cas d'erreur de lecture, zéro si la fin
+//    du fichier est atteinte. Affecte sinon à *sptr l'adresse du premier octet
+//    du bloc et à *nptr sa longueur non nulle puis renvoie une valeur
+//    strictement positive. Le bloc reste accessible jusqu'au prochain appel à
+//    input_read ou input_close avec in.
+extern int input_read(input *in, const char **sptr, size_t *nptr);
+
+//  input_close : sans effet si *inptr vaut NULL. Libère sinon les ressources
+//    allouées à la lecture du fichier associé à *inptr, le ferme s'il ne
+//    s'agit pas de l'entrée standard, ramène sinon cette dernière à son début
+//    si cela est possible, puis affecte NULL à *inptr. Renvoie une valeur non
+//    nulle si la fermeture échoue, zéro sinon.
+extern int input_close(input **inptr);
+
+#endif
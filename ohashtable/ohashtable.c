@@ -0,0 +1,366 @@
+//  ohashtable.c : partie implantation d'un module polymorphe pour la
+//    spécification TABLE du TDA Table(T, T') dans le cas d'une table de hachage
+//    par adressage ouvert.
+
+#include <stdint.h>
+#include "ohashtable.h"
+
+#if defined __SSE2__
+#include <emmintrin.h>
+#endif
+
+//  Le nombre de compartiments est une puissance de 2 qui vaut au moins
+//    « 2 ^ OHT__LBNSLOTS_MIN ». Les compartiments sont répartis en groupes
+//    consécutifs de OHT__GROUP compartiments. Dès que la proportion de
+//    compartiments qui ne sont pas vides atteindrait
+//    « (double) OHT__LDFACT_MAX_NUMER / (double) OHT__LDFACT_MAX_DENOM », les
+//    compartiments sont réorganisés et leur nombre est, si besoin, multiplié
+//    par 2.
+
+#define OHT__GROUP            16
+#define OHT__LBGROUP          4
+#define OHT__LBNSLOTS_MIN     OHT__LBGROUP
+#define OHT__LDFACT_MAX_NUMER 7
+#define OHT__LDFACT_MAX_DENOM 8
+
+//  À chaque compartiment est associé un octet de contrôle : OHT__EMPTY pour un
+//    compartiment vide, OHT__DELETED pour un compartiment dont le couple a été
+//    retiré, les 7 bits de poids faible de la valeur de hachage de la clé pour
+//    un compartiment occupé. Les deux premiers ont leur bit de poids fort à 1,
+//    le dernier à 0.
+
+#define OHT__EMPTY    0x80
+#define OHT__DELETED  0xFE
+#define OHT__H2_MASK  0x7F
+#define OHT__H2_BITS  7
+
+//  struct ohashtable, ohashtable : gestion de l'adressage ouvert par groupes à
+//    la manière des « Swiss tables ». Le composant compar mémorise la fonction
+//    de comparaison des clés, hashfun, leur fonction de pré-hachage. Les
+//    tableaux ctrl et slots mémorisent les octets de contrôle et les couples
+//    de références des compartiments, le tableau hashes les valeurs de
+//    hachage des clés des compartiments occupés, qui évitent de recalculer
+//    celles-ci lors des réorganisations ; le logarithme binaire du nombre de
+//    compartiments est mémorisé par lbnslots, qui vaut zéro tant que les
+//    tableaux n'ont pas été alloués. Le composant nentries mémorise le nombre
+//    de couples et ngrowth le nombre de compartiments vides qui peuvent encore
+//    être occupés avant réorganisation.
+//  La recherche d'une clé de valeur de hachage h parcourt les groupes à partir
+//    du groupe de numéro « (h >> OHT__H2_BITS) % nombre de groupes » selon un
+//    sondage triangulaire. Dans chaque groupe, les octets de contrôle égaux aux
+//    7 bits de poids faible de h sont repérés en une seule comparaison
+//    vectorielle et seules les clés correspondantes sont comparées. La
+//    recherche s'arrête au premier groupe qui contient un compartiment vide.
+
+struct ohashtable {
+  int (*compar)(const void *, const void *);
+  size_t (*hashfun)(const void *);
+  unsigned char *ctrl;
+  ohashtable_entry *slots;
+  size_t *hashes;
+  size_t lbnslots;
+  size_t nentries;
+  size_t ngrowth;
+};
+
+#define POW2(n) ((size_t) 1 << (n))
+#define NOT_FOUND SIZE_MAX
+
+#define OHT__IS_BLANK(oht)                                                     \
+  ((oht)->lbnslots == 0)
+
+#define OHT__CAPACITY(nslots)                                                  \
+  ((nslots) / OHT__LDFACT_MAX_DENOM * OHT__LDFACT_MAX_NUMER)
+
+//  oht__match, oht__match_empty, oht__match_free : renvoient le masque des
+//    positions, dans le groupe d'octets de contrôle d'adresse g, des octets
+//    égaux à b, égaux à OHT__EMPTY, de bit de poids fort à 1.
+
+#if defined __SSE2__
+
+static inline unsigned int oht__match(const unsigned char *g, unsigned char b) {
+  __m128i x = _mm_loadu_si128((const __m128i *) g);
+  return (unsigned int) _mm_movemask_epi8(
+      _mm_cmpeq_epi8(x, _mm_set1_epi8((char) b)));
+}
+
+static inline unsigned int oht__match_free(const unsigned char *g) {
+  return (unsigned int) _mm_movemask_epi8(
+      _mm_loadu_si128((const __m128i *) g));
+}
+
+#else
+
+static inline unsigned int oht__match(const unsigned char *g, unsigned char b) {
+  unsigned int m = 0;
+  for (unsigned int k = 0; k < OHT__GROUP; ++k) {
+    m |= (unsigned int) (g[k] == b) << k;
+  }
+  return m;
+}
+
+static inline unsigned int oht__match_free(const unsigned char *g) {
+  unsigned int m = 0;
+  for (unsigned int k = 0; k < OHT__GROUP; ++k) {
+    m |= (unsigned int) (g[k] >> 7) << k;
+  }
+  return m;
+}
+
+#endif
+
+static inline unsigned int oht__match_empty(const unsigned char *g) {
+  return oht__match(g, OHT__EMPTY);
+}
+
+#define OHT__H2(h) ((unsigned char) ((h) & OHT__H2_MASK))
+#define OHT__GROUP_START(h, lbnslots)                                          \
+  (((h) >> OHT__H2_BITS) & (POW2((lbnslots) - OHT__LBGROUP) - 1))
+
+//  ohashtable__find : recherche dans la table de hachage non vierge associée à
+//    oht une clé égale à keyref au sens de compar, de valeur de hachage h.
+//    Renvoie l'indice du compartiment qui la contient si elle existe,
+//    NOT_FOUND sinon.
+static size_t ohashtable__find(const ohashtable *oht, const void *keyref,
+    size_t h) {
+  size_t mask = POW2(oht->lbnslots - OHT__LBGROUP) - 1;
+  size_t g = OHT__GROUP_START(h, oht->lbnslots);
+  unsigned char h2 = OHT__H2(h);
+  for (size_t i = 1; ; ++i) {
+    const unsigned char *c = oht->ctrl + g * OHT__GROUP;
+    for (unsigned int m = oht__match(c, h2); m != 0; m &= m - 1) {
+      size_t k = g * OHT__GROUP + (size_t) __builtin_ctz(m);
+      if (oht->compar(keyref, oht->slots[k].keyref) == 0) {
+        return k;
+      }
+    }
+    if (oht__match_empty(c) != 0) {
+      return NOT_FOUND;
+    }
+    g = (g + i) & mask;
+  }
+}
+
+//  ohashtable__find_free : renvoie l'indice du premier compartiment vide ou
+//    dont le couple a été retiré rencontré lors de la recherche d'une clé de
+//    valeur de hachage h dans les tableaux ctrl de logarithme binaire de
+//    longueur lbnslots.
+static size_t ohashtable__find_free(const unsigned char *ctrl, size_t lbnslots,
+    size_t h) {
+  size_t mask = POW2(lbnslots - OHT__LBGROUP) - 1;
+  size_t g = OHT__GROUP_START(h, lbnslots);
+  for (size_t i = 1; ; ++i) {
+    unsigned int m = oht__match_free(ctrl + g * OHT__GROUP);
+    if (m != 0) {
+      return g * OHT__GROUP + (size_t) __builtin_ctz(m);
+    }
+    g = (g + i) & mask;
+  }
+}
+
+//  ohashtable__rehash_to : réorganise les compartiments de la table de hachage
+//    associée à oht en fixant leur nombre à « 2 ^ lbm », ce qui élimine les
+//    compartiments dont le couple a été retiré. Il est supposé que cette
+//    nouvelle configuration peut contenir tous les couples de la table.
+//    Renvoie une valeur non nulle en cas de dépassement de capacité. Renvoie
+//    sinon zéro.
+static int ohashtable__rehash_to(ohashtable *oht, size_t lbm) {
+  size_t m = POW2(lbm);
+  unsigned char *ctrl;
+  ohashtable_entry *slots;
+  size_t *hashes;
+  if (lbm >= sizeof(size_t) * 8 - 1
+      || m > SIZE_MAX / sizeof *slots
+      || (ctrl = malloc(m)) == NULL) {
+    return -1;
+  }
+  if ((slots = malloc(m * sizeof *slots)) == NULL) {
+    free(ctrl);
+    return -1;
+  }
+  if ((hashes = malloc(m * sizeof *hashes)) == NULL) {
+    free(slots);
+    free(ctrl);
+    return -1;
+  }
+  for (size_t k = 0; k < m; ++k) {
+    ctrl[k] = OHT__EMPTY;
+  }
+  if (!OHT__IS_BLANK(oht)) {
+    size_t m_ = POW2(oht->lbnslots);
+    for (size_t k_ = 0; k_ < m_; ++k_) {
+      if ((oht->ctrl[k_] & OHT__EMPTY) == 0) {
+        size_t h = oht->hashes[k_];
+        size_t k = ohashtable__find_free(ctrl, lbm, h);
+        ctrl[k] = OHT__H2(h);
+        slots[k] = oht->slots[k_];
+        hashes[k] = h;
+      }
+    }
+    free(oht->ctrl);
+    free(oht->slots);
+    free(oht->hashes);
+  }
+  oht->ctrl = ctrl;
+  oht->slots = slots;
+  oht->hashes = hashes;
+  oht->lbnslots = lbm;
+  oht->ngrowth = OHT__CAPACITY(m) - oht->nentries;
+  return 0;
+}
+
+//  ohashtable__rehash : réorganise les compartiments de la table de hachage
+//    associée à oht en doublant leur nombre si plus de la moitié de la
+//    capacité est occupée par des couples, en le conservant sinon, ce qui
+//    élimine les compartiments dont le couple a été retiré. Renvoie une valeur
+//    non nulle en cas de dépassement de capacité. Renvoie sinon zéro.
+static int ohashtable__rehash(ohashtable *oht) {
+  size_t lbm;
+  if (OHT__IS_BLANK(oht)) {
+    lbm = OHT__LBNSLOTS_MIN;
+  } else {
+    lbm = oht->lbnslots;
+    if (oht->nentries >= OHT__CAPACITY(POW2(lbm)) / 2) {
+      ++lbm;
+    }
+  }
+  return ohashtable__rehash_to(oht, lbm);
+}
+
+ohashtable *ohashtable_empty(int (*compar)(const void *, const void *),
+    size_t (*hashfun)(const void *)) {
+  ohashtable *oht = malloc(sizeof *oht);
+  if (oht == NULL) {
+    return NULL;
+  }
+  oht->compar = compar;
+  oht->hashfun = hashfun;
+  oht->ctrl = NULL;
+  oht->slots = NULL;
+  oht->hashes = NULL;
+  oht->lbnslots = 0;
+  oht->nentries = 0;
+  oht->ngrowth = 0;
+  return oht;
+}
+
+void ohashtable_dispose(ohashtable **ohtptr) {
+  if (*ohtptr == NULL) {
+    return;
+  }
+  free((*ohtptr)->ctrl);
+  free((*ohtptr)->slots);
+  free((*ohtptr)->hashes);
+  free(*ohtptr);
+  *ohtptr = NULL;
+}
+
+int ohashtable_reserve(ohashtable *oht, size_t n) {
+  size_t lbm = OHT__LBNSLOTS_MIN;
+  while (OHT__CAPACITY(POW2(lbm)) < n) {
+    if (lbm >= sizeof(size_t) * 8 - 2) {
+      return -1;
+    }
+    ++lbm;
+  }
+  if (!OHT__IS_BLANK(oht) && lbm <= oht->lbnslots) {
+    return 0;
+  }
+  return ohashtable__rehash_to(oht, lbm);
+}
+
+//  ohashtable__find_or_insert : recherche dans la table de hachage associée à
+//    oht une clé égale à keyref au sens de compar, de valeur de hachage h. Si
+//    la recherche est
+//    positive, renvoie l'adresse du compartiment qui la contient. Tente sinon
+//    d'ajouter le couple (keyref, NULL) ; renvoie NULL en cas de dépassement de
+//    capacité ; renvoie sinon l'adresse du compartiment occupé.
+static ohashtable_entry *ohashtable__find_or_insert(ohashtable *oht,
+    const void *keyref, size_t h) {
+  size_t k = NOT_FOUND;
+  if (!OHT__IS_BLANK(oht)) {
+    k = ohashtable__find(oht, keyref, h);
+    if (k != NOT_FOUND) {
+      return &oht->slots[k];
+    }
+    k = ohashtable__find_free(oht->ctrl, oht->lbnslots, h);
+  }
+  if (k == NOT_FOUND || (oht->ctrl[k] == OHT__EMPTY && oht->ngrowth == 0)) {
+    if (ohashtable__rehash(oht) != 0) {
+      return NULL;
+    }
+    k = ohashtable__find_free(oht->ctrl, oht->lbnslots, h);
+  }
+  if (oht->ctrl[k] == OHT__EMPTY) {
+    oht->ngrowth -= 1;
+  }
+  oht->ctrl[k] = OHT__H2(h);
+  oht->slots[k] = (ohashtable_entry) {
+    .keyref = keyref,
+    .valref = NULL
+  };
+  oht->hashes[k] = h;
+  oht->nentries += 1;
+  return &oht->slots[k];
+}
+
+void *ohashtable_add(ohashtable *oht, const void *keyref,
+    const void *valref) {
+  if (valref == NULL) {
+    return NULL;
+  }
+  ohashtable_entry *e = ohashtable__find_or_insert(oht, keyref,
+      oht->hashfun(keyref));
+  if (e == NULL) {
+    return NULL;
+  }
+  const void *r = e->valref;
+  e->valref = valref;
+  return (void *) (r == NULL ? valref : r);
+}
+
+ohashtable_entry *ohashtable_find_or_insert(ohashtable *oht,
+    const void *keyref) {
+  return ohashtable__find_or_insert(oht, keyref, oht->hashfun(keyref));
+}
+
+ohashtable_entry *ohashtable_find_or_insert_hashed(ohashtable *oht,
+    const void *keyref, size_t h) {
+  return ohashtable__find_or_insert(oht, keyref, h);
+}
+
+void *ohashtable_remove(ohashtable *oht, const void *keyref) {
+  if (OHT__IS_BLANK(oht)) {
+    return NULL;
+  }
+  size_t k = ohashtable__find(oht, keyref, oht->hashfun(keyref));
+  if (k == NOT_FOUND) {
+    return NULL;
+  }
+  const void *r = oht->slots[k].valref;
+  const unsigned char *g = oht->ctrl + (k & ~(size_t) (OHT__GROUP - 1));
+  if (oht__match_empty(g) != 0) {
+    oht->ctrl[k] = OHT__EMPTY;
+    oht->ngrowth += 1;
+  } else {
+    oht->ctrl[k] = OHT__DELETED;
+  }
+  oht->nentries -= 1;
+  return (void *) r;
+}
+
+void *ohashtable_search(ohashtable *oht, const void *keyref) {
+  if (OHT__IS_BLANK(oht)) {
+    return NULL;
+  }
+  return ohashtable_search_hashed(oht, keyref, oht->hashfun(keyref));
+}
+
+void *ohashtable_search_hashed(ohashtable *oht, const void *keyref,
+    size_t h) {
+  if (OHT__IS_BLANK(oht)) {
+    return NULL;
+  }
+  size_t k = ohashtable__find(oht, keyref, h);
+  return k == NOT_FOUND ? NULL : (void *) oht->slots[k].valref;
+}
@@ -0,0 +1,119 @@
+//  ohashtable.h : partie interface d'un module polymorphe pour la
+//    spécification TABLE du TDA Table(T, T') dans le cas d'une table de hachage
+//    par adressage ouvert.
+
+//  L'interface est celle du module hashtable, au préfixe des noms près : les
+//    deux modules sont interchangeables.
+
+#ifndef OHASHTABLE__H
+#define OHASHTABLE__H
+
+#include <stdlib.h>
+
+//  Fonctionnement général :
+//  - la structure de données ne stocke pas d'objets mais des références vers
+//      ces objets. Les références sont du type générique « void * » ;
+//  - si des opérations d'allocation dynamique sont effectuées, elles le sont
+//      pour la gestion propre de la structure de données, et en aucun cas pour
+//      réaliser des copies ou des destructions d'objets ;
+//  - les fonctions qui possèdent un paramètre de type « ohashtable * » ou
+//      « ohashtable ** » ont un comportement indéterminé lorsque ce paramètre
+//      ou sa déréférence n'est pas l'adresse d'un contrôleur préalablement
+//      renvoyée avec succès par la fonction ohashtable_empty et non révoquée
+//      depuis par la fonction ohashtable_dispose ;
+//  - aucune fonction ne peut ajouter NULL en tant que référence de valeur à la
+//      structure de données ;
+//  - les fonctions de type de retour « void * » renvoient NULL en cas d'échec.
+//      En cas de succès, elles renvoient une référence de valeur actuellement
+//      ou auparavant stockée par la structure de données ;
+//  - l'implantation des fonctions dont la spécification ne précise pas qu'elles
+//      doivent gérer les cas de dépassement de capacité ne doivent avoir
+//      affaire à aucun problème de la sorte.
+
+//  struct ohashtable, ohashtable : type et nom de type d'un contrôleur
+//    regroupant les informations nécessaires pour gérer une table de références
+//    de clés et valeurs quelconques.
+typedef struct ohashtable ohashtable;
+
+//  struct ohashtable_entry, ohashtable_entry : type et nom de type d'un couple
+//    de références de clé et de valeur stocké par une table de hachage.
+typedef struct ohashtable_entry ohashtable_entry;
+
+struct ohashtable_entry {
+  const void *keyref;
+  const void *valref;
+};
+
+//  ohashtable_empty : tente d'allouer les ressources nécessaires pour gérer une
+//    nouvelle table de hachage initialement vide. La fonction de comparaison
+//    des clés via leurs références est pointée par compar et leur fonction de
+//    pré-hachage est pointée par hashfun. Renvoie NULL en cas de dépassement de
+//    capacité. Renvoie sinon un pointeur vers le contrôleur associé à la table.
+extern ohashtable *ohashtable_empty(int (*compar)(const void *, const void *),
+    size_t (*hashfun)(const void *));
+
+//  ohashtable_dispose : sans effet si *ohtptr vaut NULL. Libère sinon les
+//    ressources allouées à la gestion de la table de hachage associée à
+//    *ohtptr puis affecte NULL à *ohtptr.
+extern void ohashtable_dispose(ohashtable **ohtptr);
+
+//  ohashtable_reserve : tente d'agrandir la table de hachage associée à oht de
+//    sorte qu'elle puisse contenir n couples sans être réorganisée. Sans effet
+//    si c'est déjà le cas. Renvoie une valeur non nulle en cas de dépassement
+//    de capacité. Renvoie sinon zéro.
+extern int ohashtable_reserve(ohashtable *oht, size_t n);
+
+//  ohashtable_add : renvoie NULL si valref vaut NULL. Recherche sinon dans la
+//    table de hachage associée à oht la référence d'une clé égale à celle de
+//    référence keyref au sens de la fonction de comparaison. Si la recherche
+//    est positive, remplace la référence de la valeur correspondante par valref
+//    et renvoie la référence de la valeur qui était auparavant associée à la
+//    clé trouvée. Tente sinon d'ajouter le couple (keyref, valref) à la table ;
+//    renvoie NULL en cas de dépassement de capacité ; renvoie sinon valref.
+extern void *ohashtable_add(ohashtable *oht, const void *keyref,
+    const void *valref);
+
+//  ohashtable_find_or_insert : recherche dans la table de hachage associée à
+//    oht la référence d'une clé égale à celle de référence keyref au sens de la
+//    fonction de comparaison. Si la recherche est positive, renvoie l'adresse
+//    du couple correspondant. Tente sinon d'ajouter le couple (keyref, NULL) à
+//    la table ; renvoie NULL en cas de dépassement de capacité ; renvoie sinon
+//    l'adresse du couple ajouté. Une seule recherche est effectuée dans les
+//    deux cas. Le composant valref du couple renvoyé vaut donc NULL si et
+//    seulement si le couple vient d'être ajouté : avant tout autre appel d'une
+//    fonction du module avec oht, il faut alors lui affecter une référence non
+//    nulle, la référence keyref pouvant aussi être remplacée par celle d'une
+//    clé égale, ou bien retirer le couple avec ohashtable_remove. L'adresse
+//    renvoyée reste valide jusqu'au prochain appel d'une fonction du module
+//    avec oht.
+extern ohashtable_entry *ohashtable_find_or_insert(ohashtable *oht,
+    const void *keyref);
+
+//  ohashtable_find_or_insert_hashed : comme ohashtable_find_or_insert, h étant
+//    la valeur de pré-hachage de la clé de référence keyref, supposée égale à
+//    celle que renverrait la fonction de pré-hachage, qui n'est alors pas
+//    appelée.
+extern ohashtable_entry *ohashtable_find_or_insert_hashed(ohashtable *oht,
+    const void *keyref, size_t h);
+
+//  ohashtable_remove : recherche dans la table de hachage associée à oht la
+//    référence d'une clé égale à celle de référence keyref au sens de la
+//    fonction de comparaison. Si la recherche est négative, renvoie NULL.
+//    Retire sinon le couple (fkeyref, fvalref) de la table, où fkeyref est la
+//    référence de la clé trouvée et fvalref la référence de la valeur
+//    correspondante et renvoie fvalref.
+extern void *ohashtable_remove(ohashtable *oht, const void *keyref);
+
+//  ohashtable_search : recherche dans la table de hachage associée à oht la
+//    référence d'une clé égale à celle de référence keyref au sens de la
+//    fonction de comparaison. Renvoie NULL si la recherche est négative, la
+//    référence de la valeur correspondante sinon.
+extern void *ohashtable_search(ohashtable *oht, const void *keyref);
+
+//  ohashtable_search_hashed : comme ohashtable_search, h étant la valeur de
+//    pré-hachage de la clé de référence keyref, supposée égale à celle que
+//    renverrait la fonction de pré-hachage, qui n'est alors pas appelée.
+extern void *ohashtable_search_hashed(ohashtable *oht, const void *keyref,
+    size_t h);
+
+#endif
@@ -4,6 +4,7 @@
 #include "word.h"
 #include <ctype.h>
 #include <errno.h>
+#include <limits.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -39,11 +40,19 @@
 #define PROCESS  "Processing\n"
 #define AVL_DESC "  -a\t\t\tSame as --words-processing=avl-binary-tree.\n\n"
 #define HT_DESC "  -h\t\t\tSame as --words-processing=hash-table.\n\n"
+#define OHT_DESC "  -o\t\t\tSame as --words-processing=open-addressing.\n\n"
+#define EXPECTED_DESC                                                          \
+  "      --expected-words=N\tSize the data structure for N\n"                 \
+  "\t\t\tdistinct words. 0 means that N is estimated\n"                      \
+  "\t\t\tfrom the total size of the FILES. Default is 0.\n\n"
 #define WT_PROCESS_DESC                                                        \
   "  -w, --words-processing=TYPE\tProcess the words according\n"               \
   "\t\t\tto the data structure specified by TYPE. The\n"                       \
   "\t\t\tavailable values for TYPE are self explanatory:\n"                    \
-  "\t\t\t'avl-binary-tree' and 'hash-table'. Default is\n"                     \
+  "\t\t\t'avl-binary-tree', 'btree' (B+ tree),\n"                            \
+  "\t\t\t'hash-table', 'open-addressing' (hash table\n"                       \
+  "\t\t\twith open addressing) and 'radix-tree'\n"                            \
+  "\t\t\t(adaptive radix tree). Default is\n"                                 \
   "\t\t\t'hash-table'.\n"
 #define INPUT_C "Input Control\n"
 #define I_VAL_DESC                                                             \
@@ -54,6 +63,10 @@
   "  -p, --punctuation-like-space\tMake the punctuation characters\n"          \
   "\t\t\t  play the same role as white-space\n"                                \
   "\t\t\t  characters in the meaning of words.\n\n"
+#define DELIM_DESC                                                             \
+  "  -d, --delimiters=SET\tMake the characters of SET play the\n"             \
+  "\t\t\t  same role as white-space characters in the\n"                     \
+  "\t\t\t  meaning of words.\n\n"
 #define RFILE_DESC                                                             \
   "  -r, --restrict=FILE\tLimit the counting to the set of\n"                  \
   "\t\t\t  words that appear in FILE. FILE is displayed\n"                     \
@@ -84,11 +97,16 @@
 #define LWORD_PROCESS "words-processing"
 #define LMAX_L_VAL "initial"
 #define LPUNCT "punctuation-like-space"
+#define LDELIM "delimiters"
 #define LREV "reverse"
 #define LRESTRICT "restrict"
+#define LEXPECTED "expected-words"
 
 #define TYPE_AVL "avl-binary-tree"
 #define TYPE_HT "hash-table"
+#define TYPE_OHT "open-addressing"
+#define TYPE_BTREE "btree"
+#define TYPE_ART "radix-tree"
 
 #define TYPE_S_LEXICO "lexicographical"
 #define TYPE_S_NUM "numeric"
@@ -96,6 +114,7 @@
 
 #define WORD_PROCESS_AVL 'a'
 #define WORD_PROCESS_HT 'h'
+#define WORD_PROCESS_OHT 'o'
 #define WORD_PROCESS_TYPE 'w'
 
 #define SORT_LEXICO 'l'
@@ -111,6 +130,7 @@
 #define SORT_NONE_CODE 0
 
 #define PUNCT_SPACE 'p'
+#define DELIMITERS 'd'
 #define MAX_L_VAL 'i'
 #define OPT_HELP  '?'
 
@@ -122,9 +142,10 @@ int errno;
 struct options {
   int sort_type;
   bool reversed_sort;
-  bool word_process_ht;
+  wprocess word_process;
   long int value;
-  int (*isblank)(int);
+  long int expected;
+  bool delim[UCHAR_MAX + 1];
   const char *r_file;
 };
 
@@ -135,9 +156,12 @@ options *options_default() {
   }
   opt->sort_type = SORT_NONE_CODE;
   opt->reversed_sort = false;
-  opt->word_process_ht = true;
+  opt->word_process = WPROCESS_HT;
   opt->value = I_VAL_DEFAULT;
-  opt->isblank = isspace;
+  opt->expected = EXPECTED_DEFAULT;
+  for (int c = 0; c <= UCHAR_MAX; ++c) {
+    opt->delim[c] = isspace(c);
+  }
   opt->r_file = NULL;
   return opt;
 }
@@ -150,10 +174,20 @@ void options_dispose(options **opt_ptr) {
   *opt_ptr = NULL;
 }
 
-//  is_space_or_punct : Renvoie 1 si le caractère c est un espace ou une
-//    ponctuation, 0 sinon.
-static int is_space_or_punct(int c) {
-  return isspace(c) || ispunct(c);
+//  opt__add_punct : ajoute les caractères de ponctuation à la table des
+//    délimiteurs de opt.
+static void opt__add_punct(options *opt) {
+  for (int c = 0; c <= UCHAR_MAX; ++c) {
+    opt->delim[c] = opt->delim[c] || ispunct(c);
+  }
+}
+
+//  opt__add_delimiters : ajoute les caractères de la chaine s à la table des
+//    délimiteurs de opt.
+static void opt__add_delimiters(options *opt, const char *s) {
+  for (const unsigned char *p = (const unsigned char *) s; *p != '\0'; ++p) {
+    opt->delim[*p] = true;
+  }
 }
 
 //  op__help: affiche sur la sortie standard les informations d'aide
@@ -169,10 +203,13 @@ static int op__help() {
       PROCESS
       AVL_DESC
       HT_DESC
+      OHT_DESC
+      EXPECTED_DESC
       WT_PROCESS_DESC
       INPUT_C
       I_VAL_DESC
       PUNC_DESC
+      DELIM_DESC
       RFILE_DESC
       OUTPUT_CONTROL
       LSORT_DESC
@@ -262,10 +299,13 @@ static opreturn short_options_manager(int argc, char **argv, int *k,
         opt->r_file = strcmp(s, READ_FROM_STDIN) == 0 ? STDIN_FILE : s;
         break;
       case WORD_PROCESS_AVL:
-        opt->word_process_ht = false;
+        opt->word_process = WPROCESS_AVL;
         break;
       case WORD_PROCESS_HT:
-        opt->word_process_ht = true;
+        opt->word_process = WPROCESS_HT;
+        break;
+      case WORD_PROCESS_OHT:
+        opt->word_process = WPROCESS_OHT;
         break;
       case WORD_PROCESS_TYPE:
         s = p + 1;
@@ -275,13 +315,31 @@ static opreturn short_options_manager(int argc, char **argv, int *k,
         }
         int rl = l_prefix(s, TYPE_AVL, arg_);
         if (rl > 0) {
-          opt->word_process_ht = false;
+          opt->word_process = WPROCESS_AVL;
           arg_l = rl;
           break;
         }
         rl = l_prefix(s, TYPE_HT, arg_);
         if (rl > 0) {
-          opt->word_process_ht = true;
+          opt->word_process = WPROCESS_HT;
+          arg_l = rl;
+          break;
+        }
+        rl = l_prefix(s, TYPE_OHT, arg_);
+        if (rl > 0) {
+          opt->word_process = WPROCESS_OHT;
+          arg_l = rl;
+          break;
+        }
+        rl = l_prefix(s, TYPE_BTREE, arg_);
+        if (rl > 0) {
+          opt->word_process = WPROCESS_BTREE;
+          arg_l = rl;
+          break;
+        }
+        rl = l_prefix(s, TYPE_ART, arg_);
+        if (rl > 0) {
+          opt->word_process = WPROCESS_ART;
           arg_l = rl;
           break;
         }
@@ -330,7 +388,16 @@ static opreturn short_options_manager(int argc, char **argv, int *k,
         opt->reversed_sort = true;
         break;
       case PUNCT_SPACE:
-        opt->isblank = is_space_or_punct;
+        opt__add_punct(opt);
+        break;
+      case DELIMITERS:
+        s = p + 1;
+        test = get_arg_pos(&s, &k, &arg_, argc, argv);
+        if (test == OP_RETURN_INVALID_ARGUMENT) {
+          return OP_RETURN_INVALID_ARGUMENT;
+        }
+        arg_l = (int) strlen(s);
+        opt__add_delimiters(opt, s);
         break;
       case MAX_L_VAL:
         s = p + 1;
@@ -394,7 +461,7 @@ static opreturn long_options_manager(char *arg, options *opt) {
     return op_usage();
   }
   if (strncmp(p, LPUNCT, strlen(p)) == 0) {
-    opt->isblank = is_space_or_punct;
+    opt__add_punct(opt);
     return 0;
   }
   if (strncmp(p, LREV, strlen(p)) == 0) {
@@ -429,16 +496,37 @@ static opreturn long_options_manager(char *arg, options *opt) {
       return OP_RETURN_INVALID_ARGUMENT;
     }
     if (ll_prefix(q, TYPE_AVL) != NULL) {
-      opt->word_process_ht = false;
+      opt->word_process = WPROCESS_AVL;
       return OP_RETURN_SUCCESS;
     }
     if (ll_prefix(q, TYPE_HT) != NULL) {
-      opt->word_process_ht = true;
+      opt->word_process = WPROCESS_HT;
+      return OP_RETURN_SUCCESS;
+    }
+    if (ll_prefix(q, TYPE_OHT) != NULL) {
+      opt->word_process = WPROCESS_OHT;
+      return OP_RETURN_SUCCESS;
+    }
+    if (ll_prefix(q, TYPE_BTREE) != NULL) {
+      opt->word_process = WPROCESS_BTREE;
+      return OP_RETURN_SUCCESS;
+    }
+    if (ll_prefix(q, TYPE_ART) != NULL) {
+      opt->word_process = WPROCESS_ART;
       return OP_RETURN_SUCCESS;
     }
     ERROR_MSG(PROCESS_UNKNOWN, arg);
     return OP_RETURN_INVALID_ARGUMENT;
   }
+  q = ll_prefix(p, LDELIM);
+  if (q != NULL) {
+    if (*q != '=' || *(++q) == '\0') {
+      ERROR_MSG(MISSING_ARG, arg);
+      return OP_RETURN_INVALID_ARGUMENT;
+    }
+    opt__add_delimiters(opt, q);
+    return OP_RETURN_SUCCESS;
+  }
   q = ll_prefix(p, LRESTRICT);
   if (q != NULL) {
     if (*q == '\0' || *(++q) == '\0') {
@@ -467,6 +555,26 @@ static opreturn long_options_manager(char *arg, options *opt) {
     opt->value = n;
     return OP_RETURN_SUCCESS;
   }
+  q = ll_prefix(p, LEXPECTED);
+  if (q != NULL) {
+    if (*q != '=' || *(++q) == '\0') {
+      ERROR_MSG(MISSING_ARG, arg);
+      return OP_RETURN_INVALID_ARGUMENT;
+    }
+    char *endptr;
+    errno = 0;
+    long int n = strtol(q, &endptr, 10);
+    if (*q == *endptr || *endptr != '\0' || n < 0) {
+      ERROR_MSG(EXPECTED_ERR, arg);
+      return OP_RETURN_INVALID_ARGUMENT;
+    }
+    if (errno != 0) {
+      ERROR_MSG(OVERFLOW, arg);
+      return OP_RETURN_INVALID_ARGUMENT;
+    }
+    opt->expected = n;
+    return OP_RETURN_SUCCESS;
+  }
   ERROR_MSG(ERR_OP, arg);
   return OP_RETURN_UNKNOWN_OP;
 }
@@ -486,18 +594,22 @@ bool opt_get_reversed(options *opt) {
   return opt->reversed_sort;
 }
 
-bool opt_get_word_process(options *opt) {
-  return opt->word_process_ht;
+wprocess opt_get_word_process(options *opt) {
+  return opt->word_process;
 }
 
-int(*opt_get_isblank_func(options * opt)) (int) {
-  return opt->isblank;
+const bool *opt_get_delim_table(options *opt) {
+  return opt->delim;
 }
 
 long int opt_get_ivalue(options *opt) {
   return opt->value;
 }
 
+long int opt_get_expected(options *opt) {
+  return opt->expected;
+}
+
 const char *opt_get_r_file(options *opt) {
   return opt->r_file;
 }
@@ -12,6 +12,7 @@
 #define READ_FROM_STDIN "-"
 #define STDIN_FILE "\"\""
 #define I_VAL_DEFAULT 0
+#define EXPECTED_DEFAULT 0
 
 typedef enum {
   OP_RETURN_SUCCESS,
@@ -29,9 +30,20 @@ typedef enum {
 #define PROCESS_UNKNOWN "Unknown word processing type"
 #define OVERFLOW "Overflowing argument"
 #define MAX_VAL_ERR "Invalid value for max length"
+#define EXPECTED_ERR "Invalid value for expected words"
 #define ERR_OP "Unrecognized option"
 #define SORT_UNKNOWN "Unknown sort type"
 
+//  wprocess : type des structures de données utilisables pour le traitement
+//    des mots.
+typedef enum {
+  WPROCESS_HT,
+  WPROCESS_AVL,
+  WPROCESS_OHT,
+  WPROCESS_BTREE,
+  WPROCESS_ART
+} wprocess;
+
 //  struct options, options: type et nom de type d'un contrôleur regroupant
 //    les informations nécessaires pour gérer les options entrées en ligne de
 //    commande.
@@ -62,16 +74,22 @@ extern bool opt_get_reversed(options *opt);
 
 //  opt_get_word_process : Renvoie le champ associé à l'option de traitement des
 //    mot de opt.
-extern bool opt_get_word_process(options *opt);
+extern wprocess opt_get_word_process(options *opt);
 
-//  opt_get_word_process : Renvoie le champ associé à l'option de ponctuation
-//    de opt.
-extern int(*opt_get_isblank_func(options * opt)) (int);
+//  opt_get_delim_table : Renvoie la table des délimiteurs de mots de opt,
+//    indicée par les valeurs des caractères convertis en unsigned char. Elle
+//    est construite lors du traitement des options et tient compte de l'option
+//    de ponctuation et des délimiteurs donnés par l'utilisateur.
+extern const bool *opt_get_delim_table(options *opt);
 
 //  opt_get_value : Renvoie le champ associé à l'option de la longeur max d'un
 //    mot de opt.
 extern long int opt_get_ivalue(options *opt);
 
+//  opt_get_expected : Renvoie le champ associé à l'option du nombre de mots
+//    distincts attendus de opt.
+extern long int opt_get_expected(options *opt);
+
 //  opt_get_value : Renvoie le champ associé à l'option restrict de opt.
 extern const char *opt_get_r_file(options *opt);
 
@@ -0,0 +1,220 @@
+//  Partie implantation du module rsort.
+
+#include "rsort.h"
+#include <limits.h>
+#include <stdint.h>
+#include <string.h>
+
+//  RSORT__RADIX : nombre de valeurs d'un octet, et donc de paquets entre
+//    lesquels une passe répartit les références.
+#define RSORT__RADIX (UCHAR_MAX + 1)
+
+//  RSORT__RANK : rang du paquet recevant les références dont l'octet examiné
+//    vaut v, pour un tri croissant ou décroissant selon la valeur de dir.
+//    Dans l'ordre décroissant, l'octet nul, qui termine une chaine, reste
+//    celui du dernier paquet.
+#define RSORT__RANK(v, dir, nul_last)                                          \
+  ((dir) <= 0 ? (v) : (nul_last) && (v) == 0 ? UCHAR_MAX : UCHAR_MAX - (v))
+
+//  RSORT__INSERTION_MAX : nombre de références en deçà duquel rsort_str trie
+//    une suite de références par insertion plutôt que par répartition.
+#define RSORT__INSERTION_MAX 32
+
+//--- Clés entières ------------------------------------------------------------
+
+//  struct rsort__item, rsort__item : une référence accompagnée de sa clé, lue
+//    une seule fois avant le tri.
+typedef struct rsort__item rsort__item;
+
+struct rsort__item {
+  unsigned long key;
+  void *ref;
+};
+
+int rsort_ulong(void **a, size_t n, int dir,
+    unsigned long (*key)(const void *ref)) {
+  if (n <= 1) {
+    return 0;
+  }
+  if (n > SIZE_MAX / sizeof(rsort__item) / 2) {
+    return -1;
+  }
+  rsort__item *items = malloc(2 * n * sizeof *items);
+  if (items == NULL) {
+    return -1;
+  }
+  rsort__item *x = items;
+  rsort__item *y = items + n;
+  unsigned long keys = 0;
+  for (size_t k = 0; k < n; ++k) {
+    x[k].key = key(a[k]);
+    x[k].ref = a[k];
+    keys |= x[k].key;
+  }
+  for (size_t shift = 0; shift < sizeof keys * CHAR_BIT && keys >> shift != 0;
+      shift += CHAR_BIT) {
+    size_t count[RSORT__RADIX] = {
+      0
+    };
+    for (size_t k = 0; k < n; ++k) {
+      ++count[RSORT__RANK((unsigned char) (x[k].key >> shift), dir, 0)];
+    }
+    if (count[RSORT__RANK((unsigned char) (x[0].key >> shift), dir, 0)]
+        == n) {
+      continue;
+    }
+    size_t pos = 0;
+    for (size_t r = 0; r < RSORT__RADIX; ++r) {
+      size_t c = count[r];
+      count[r] = pos;
+      pos += c;
+    }
+    for (size_t k = 0; k < n; ++k) {
+      y[count[RSORT__RANK((unsigned char) (x[k].key >> shift), dir, 0)]++]
+        = x[k];
+    }
+    rsort__item *z = x;
+    x = y;
+    y = z;
+  }
+  for (size_t k = 0; k < n; ++k) {
+    a[k] = x[k].ref;
+  }
+  free(items);
+  return 0;
+}
+
+//--- Clés chaines -------------------------------------------------------------
+
+//  struct rsort__segment, rsort__segment : suite de n références du tableau
+//    à trier, à partir de la composante d'indice start, dont les chaines ont
+//    les mêmes depth premiers octets.
+typedef struct rsort__segment rsort__segment;
+
+struct rsort__segment {
+  size_t start;
+  size_t n;
+  size_t depth;
+};
+
+//  struct rsort__stack, rsort__stack : pile des suites qui restent à trier,
+//    mémorisée dans un tableau dynamique de capacité capacity.
+typedef struct rsort__stack rsort__stack;
+
+struct rsort__stack {
+  rsort__segment *segments;
+  size_t n;
+  size_t capacity;
+};
+
+#define RSORT__STACK_MIN 64
+
+//  rsort__push : tente d'empiler la suite (start, n, depth) sur la pile
+//    associée à st, en doublant au besoin sa capacité. Renvoie une valeur non
+//    nulle en cas de dépassement de capacité. Renvoie sinon zéro.
+static int rsort__push(rsort__stack *st, size_t start, size_t n,
+    size_t depth) {
+  if (st->n == st->capacity) {
+    size_t cap = st->capacity == 0 ? RSORT__STACK_MIN : 2 * st->capacity;
+    if (cap > SIZE_MAX / sizeof *st->segments) {
+      return -1;
+    }
+    rsort__segment *s = realloc(st->segments, cap * sizeof *s);
+    if (s == NULL) {
+      return -1;
+    }
+    st->segments = s;
+    st->capacity = cap;
+  }
+  st->segments[st->n] = (rsort__segment) {
+    start, n, depth
+  };
+  st->n += 1;
+  return 0;
+}
+
+//  rsort__isort : trie par insertion le tableau de longueur n pointé par a
+//    selon l'ordre de strcmp des chaines de valeurs str pour ses références,
+//    privées de leurs depth premiers octets, qui sont égaux.
+static void rsort__isort(void **a, size_t n, size_t depth, int dir,
+    const char *(*str)(const void *ref)) {
+  for (size_t k = 1; k < n; ++k) {
+    void *ref = a[k];
+    const char *s = str(ref) + depth;
+    size_t j = k;
+    while (j > 0) {
+      int c = strcmp(str(a[j - 1]) + depth, s);
+      if (dir <= 0 ? c <= 0 : c >= 0) {
+        break;
+      }
+      a[j] = a[j - 1];
+      --j;
+    }
+    a[j] = ref;
+  }
+}
+
+int rsort_str(void **a, size_t n, int dir,
+    const char *(*str)(const void *ref)) {
+  if (n <= 1) {
+    return 0;
+  }
+  if (n > SIZE_MAX / sizeof *a) {
+    return -1;
+  }
+  void **t = malloc(n * sizeof *t);
+  unsigned char *ranks = malloc(n);
+  rsort__stack st = {
+    NULL, 0, 0
+  };
+  int r = -1;
+  if (t == NULL || ranks == NULL || rsort__push(&st, 0, n, 0) != 0) {
+    goto dispose;
+  }
+  const size_t nul = RSORT__RANK(0, dir, 1);
+  while (st.n > 0) {
+    st.n -= 1;
+    rsort__segment sg = st.segments[st.n];
+    void **b = a + sg.start;
+    if (sg.n < RSORT__INSERTION_MAX) {
+      rsort__isort(b, sg.n, sg.depth, dir, str);
+      continue;
+    }
+    size_t count[RSORT__RADIX];
+    for (;;) {
+      memset(count, 0, sizeof count);
+      for (size_t k = 0; k < sg.n; ++k) {
+        unsigned char v = (unsigned char) str(b[k])[sg.depth];
+        ranks[k] = (unsigned char) RSORT__RANK(v, dir, 1);
+        ++count[ranks[k]];
+      }
+      if (count[ranks[0]] != sg.n || ranks[0] == nul) {
+        break;
+      }
+      sg.depth += 1;
+    }
+    if (count[ranks[0]] == sg.n) {
+      continue;
+    }
+    size_t pos = 0;
+    for (size_t k = 0; k < RSORT__RADIX; ++k) {
+      size_t c = count[k];
+      if (k != nul && c > 1
+          && rsort__push(&st, sg.start + pos, c, sg.depth + 1) != 0) {
+        goto dispose;
+      }
+      count[k] = pos;
+      pos += c;
+    }
+    for (size_t k = 0; k < sg.n; ++k) {
+      t[count[ranks[k]]++] = b[k];
+    }
+    memcpy(b, t, sg.n * sizeof *b);
+  }
+  r = 0;
+dispose:
+  free(st.segments);
+  free(ranks);
+  free(t);
+  return r;
+}
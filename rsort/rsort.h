@@ -0,0 +1,39 @@
+//  rsort : Un module proposant des tris par base de tableaux de références,
+//    selon une clé entière ou une clé chaine associée à chaque référence.
+
+#ifndef RSORT__H
+#define RSORT__H
+
+#include <stdlib.h>
+
+//  Fonctionnement général :
+//  - les tris ne comparent pas les clés deux à deux : ils répartissent les
+//      références selon les octets successifs de leurs clés. Leur durée croît
+//      ainsi linéairement avec le nombre de références et la longueur des
+//      clés, sans appel à une fonction de comparaison ;
+//  - les tris sont stables : deux références de clés égales restent dans
+//      l'ordre dans lequel elles figuraient dans le tableau ;
+//  - l'ordre est croissant ou décroissant selon que la valeur du paramètre dir
+//      est inférieure ou égale à zéro ou non ;
+//  - les tris allouent un espace de travail proportionnel au nombre de
+//      références. En cas de dépassement de capacité, ils renvoient une valeur
+//      non nulle et l'ordre des références du tableau n'est pas spécifié. Ils
+//      renvoient sinon zéro.
+
+//  rsort_ulong : trie le tableau de longueur n pointé par a selon les valeurs
+//    de key pour ses références, par base 256 en commençant par l'octet de
+//    poids faible. Les octets de poids fort nuls pour toutes les clés ne sont
+//    pas examinés.
+extern int rsort_ulong(void **a, size_t n, int dir,
+    unsigned long (*key)(const void *ref));
+
+//  rsort_str : trie le tableau de longueur n pointé par a selon l'ordre de
+//    strcmp des chaines de valeurs str pour ses références, par base 256 en
+//    commençant par le premier octet. Les références dont les chaines ont
+//    les mêmes premiers octets ne sont réparties que selon les octets
+//    suivants, jusqu'à être séparées ou en nombre suffisamment petit pour
+//    être triées par insertion.
+extern int rsort_str(void **a, size_t n, int dir,
+    const char *(*str)(const void *ref));
+
+#endif
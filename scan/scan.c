@@ -0,0 +1,189 @@
+//  Partie implantation du module scan.
+
+#include "scan.h"
+#include <limits.h>
+#include <string.h>
+#include "hash.h"
+
+#if defined __SSE2__ && (defined __x86_64__ || defined __i386__)
+#define SCAN__X86 1
+#include <immintrin.h>
+#else
+#define SCAN__X86 0
+#endif
+
+//  SCAN__NRANGES_MAX : nombre maximal d'intervalles d'octets délimiteurs au
+//    delà duquel la recherche n'est pas vectorisée.
+#define SCAN__NRANGES_MAX 8
+
+//  struct scan, scan : le tableau delim mémorise la table des délimiteurs.
+//    L'ensemble des délimiteurs est aussi décrit, s'il est la réunion d'au
+//    plus SCAN__NRANGES_MAX intervalles disjoints, par les composants nranges,
+//    lo et width : le k-ième intervalle est [lo[k], lo[k] + width[k]]. Si ce
+//    n'est pas le cas, nranges vaut zéro. Le composant find mémorise la
+//    fonction de recherche choisie à l'initialisation : elle renvoie l'adresse
+//    du premier octet de [s, e) dont l'appartenance aux délimiteurs vaut
+//    want_delim, e à défaut.
+struct scan {
+  bool delim[UCHAR_MAX + 1];
+  size_t nranges;
+  unsigned char lo[SCAN__NRANGES_MAX];
+  unsigned char width[SCAN__NRANGES_MAX];
+  const char *(*find)(const scan *sc, const char *s, const char *e,
+      bool want_delim);
+};
+
+//  scan__find_scalar : recherche octet par octet à l'aide de la table.
+static const char *scan__find_scalar(const scan *sc, const char *s,
+    const char *e, bool want_delim) {
+  while (s < e && sc->delim[(unsigned char) *s] != want_delim) {
+    ++s;
+  }
+  return s;
+}
+
+#if SCAN__X86
+
+//  scan__mask_sse2 : renvoie le masque des positions des délimiteurs parmi les
+//    16 octets qui commencent à l'adresse s. Un octet x appartient à
+//    l'intervalle [lo, lo + width] si et seulement si l'octet x - lo, calculé
+//    modulo 256, est inférieur ou égal à width.
+static inline unsigned int scan__mask_sse2(const scan *sc, const char *s) {
+  __m128i x = _mm_loadu_si128((const __m128i *) s);
+  __m128i m = _mm_setzero_si128();
+  for (size_t k = 0; k < sc->nranges; ++k) {
+    __m128i d = _mm_sub_epi8(x, _mm_set1_epi8((char) sc->lo[k]));
+    __m128i w = _mm_set1_epi8((char) sc->width[k]);
+    m = _mm_or_si128(m, _mm_cmpeq_epi8(_mm_min_epu8(d, w), d));
+  }
+  return (unsigned int) _mm_movemask_epi8(m);
+}
+
+//  scan__find_sse2 : recherche par blocs de 16 octets.
+static const char *scan__find_sse2(const scan *sc, const char *s,
+    const char *e, bool want_delim) {
+  unsigned int flip = want_delim ? 0 : 0xFFFF;
+  while (e - s >= 16) {
+    unsigned int bits = scan__mask_sse2(sc, s) ^ flip;
+    if (bits != 0) {
+      return s + __builtin_ctz(bits);
+    }
+    s += 16;
+  }
+  return scan__find_scalar(sc, s, e, want_delim);
+}
+
+//  scan__find_avx2 : analogue à scan__find_sse2 par blocs de 32 octets.
+__attribute__((target("avx2")))
+static const char *scan__find_avx2(const scan *sc, const char *s,
+    const char *e, bool want_delim) {
+  unsigned int flip = want_delim ? 0 : 0xFFFFFFFFu;
+  while (e - s >= 32) {
+    __m256i x = _mm256_loadu_si256((const __m256i *) s);
+    __m256i m = _mm256_setzero_si256();
+    for (size_t k = 0; k < sc->nranges; ++k) {
+      __m256i d = _mm256_sub_epi8(x, _mm256_set1_epi8((char) sc->lo[k]));
+      __m256i w = _mm256_set1_epi8((char) sc->width[k]);
+      m = _mm256_or_si256(m, _mm256_cmpeq_epi8(_mm256_min_epu8(d, w), d));
+    }
+    unsigned int bits = ((unsigned int) _mm256_movemask_epi8(m)) ^ flip;
+    if (bits != 0) {
+      return s + __builtin_ctz(bits);
+    }
+    s += 32;
+  }
+  return scan__find_sse2(sc, s, e, want_delim);
+}
+
+#endif
+
+//  scan__ranges : décompose l'ensemble des délimiteurs de sc en intervalles
+//    disjoints et les mémorise si leur nombre ne dépasse pas
+//    SCAN__NRANGES_MAX. Affecte sinon zéro à nranges.
+static void scan__ranges(scan *sc) {
+  size_t n = 0;
+  int c = 0;
+  while (c <= UCHAR_MAX) {
+    if (!sc->delim[c]) {
+      ++c;
+      continue;
+    }
+    int lo = c;
+    while (c <= UCHAR_MAX && sc->delim[c]) {
+      ++c;
+    }
+    if (n == SCAN__NRANGES_MAX) {
+      sc->nranges = 0;
+      return;
+    }
+    sc->lo[n] = (unsigned char) lo;
+    sc->width[n] = (unsigned char) (c - 1 - lo);
+    ++n;
+  }
+  sc->nranges = n;
+}
+
+scan *scan_init(const bool *delim) {
+  scan *sc = malloc(sizeof *sc);
+  if (sc == NULL) {
+    return NULL;
+  }
+  memcpy(sc->delim, delim, sizeof sc->delim);
+  scan__ranges(sc);
+  sc->find = scan__find_scalar;
+#if SCAN__X86
+  if (sc->nranges != 0) {
+    sc->find = __builtin_cpu_supports("avx2")
+      ? scan__find_avx2
+      : scan__find_sse2;
+  }
+#endif
+  return sc;
+}
+
+const char *scan_delim(const scan *sc, const char *s, const char *e) {
+  return sc->find(sc, s, e, true);
+}
+
+const char *scan_word(const scan *sc, const char *s, const char *e) {
+  return sc->find(sc, s, e, false);
+}
+
+const char *scan_delim_hash(const scan *sc, const char *s, const char *e,
+    uint64_t seed, uint64_t *hptr) {
+  uint64_t state = hash_start(seed);
+  const char *p = s;
+  const char *t = NULL;
+#if SCAN__X86 && HASH_BLOCK == 16
+  if (sc->nranges != 0) {
+    while (t == NULL && e - p > HASH_BLOCK) {
+      unsigned int bits = scan__mask_sse2(sc, p);
+      if (bits != 0) {
+        t = p + __builtin_ctz(bits);
+      } else if (sc->delim[(unsigned char) p[HASH_BLOCK]]) {
+        t = p + HASH_BLOCK;
+      } else {
+        state = hash_step(state, p);
+        p += HASH_BLOCK;
+      }
+    }
+  }
+#endif
+  if (t == NULL) {
+    t = scan__find_scalar(sc, p, e, true);
+  }
+  while (t - p > HASH_BLOCK) {
+    state = hash_step(state, p);
+    p += HASH_BLOCK;
+  }
+  *hptr = hash_finish(state, s, (size_t) (t - s));
+  return t;
+}
+
+void scan_dispose(scan **scptr) {
+  if (*scptr == NULL) {
+    return;
+  }
+  free(*scptr);
+  *scptr = NULL;
+}
@@ -0,0 +1,50 @@
+//  scan : Un module permettant de rechercher rapidement dans une suite d'octets
+//    le prochain délimiteur de mots ou le prochain caractère de mot, selon une
+//    table des délimiteurs mémorisée dans une structure nommée « scan ».
+//  Sur les architectures x86, la recherche est vectorisée (SSE2, ou AVX2 si
+//    le processeur le permet, ce qui est déterminé à l'exécution) lorsque
+//    l'ensemble des délimiteurs est une réunion d'au plus quelques intervalles
+//    d'octets. Elle se fait sinon octet par octet à l'aide de la table.
+
+#ifndef SCAN__H
+#define SCAN__H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+//  struct scan, scan : type et nom de type d'un contrôleur regroupant les
+//    informations nécessaires pour rechercher des délimiteurs de mots.
+typedef struct scan scan;
+
+//  scan_init : tente d'allouer les ressources nécessaires pour rechercher les
+//    délimiteurs de mots décrits par la table delim, indicée par les valeurs
+//    des caractères convertis en unsigned char. Renvoie NULL en cas de
+//    dépassement de capacité. Renvoie sinon un pointeur vers le contrôleur
+//    associé.
+extern scan *scan_init(const bool *delim);
+
+//  scan_delim : renvoie l'adresse du premier délimiteur de mots dans la suite
+//    d'octets qui commence à l'adresse s et se termine juste avant l'adresse e.
+//    Renvoie e si cette suite n'en contient pas.
+extern const char *scan_delim(const scan *sc, const char *s, const char *e);
+
+//  scan_delim_hash : renvoie, comme scan_delim, l'adresse t du premier
+//    délimiteur de mots dans la suite d'octets qui commence à l'adresse s et se
+//    termine juste avant l'adresse e, ou e à défaut. Affecte à *hptr la valeur
+//    de hachage par hash_bytes, pour la graine seed, de la suite d'octets qui
+//    commence à l'adresse s et se termine juste avant t. La valeur de hachage
+//    est calculée au fil de la recherche, bloc par bloc.
+extern const char *scan_delim_hash(const scan *sc, const char *s, const char *e,
+    uint64_t seed, uint64_t *hptr);
+
+//  scan_word : renvoie l'adresse du premier octet qui n'est pas un délimiteur
+//    de mots dans la suite d'octets qui commence à l'adresse s et se termine
+//    juste avant l'adresse e. Renvoie e si cette suite n'en contient pas.
+extern const char *scan_word(const scan *sc, const char *s, const char *e);
+
+//  scan_dispose : sans effet si *scptr vaut NULL. Libère sinon les ressources
+//    allouées au contrôleur associé à *scptr puis affecte NULL à *scptr.
+extern void scan_dispose(scan **scptr);
+
+#endif
@@ -1,8 +1,8 @@
 //  Affiche le nombre d’occurrences de chaque mot qui apparait dans un et un
 //    seul (de manière exclusive) des fichiers dont les noms figurent sur la
 //    ligne de commande avec les options demandées.
-//  - Utilisation d'une table de hachage par défaut, un arbre avl si demandé
-//    dans les options.
+//  - Utilisation d'une table de hachage par défaut, d'un arbre avl, d'un
+//    B+arbre ou d'un arbre radix adaptatif si demandé dans les options.
 //  - Un mot est, par défaut, une séquence de longueur maximale de caractères
 //    n’appartenant pas à la classe isspace, et donc de longueur indéfinie.
 //  - Options et fichiers peuvent être entremêlés sur la ligne de commande.
@@ -11,7 +11,14 @@
 //    longues.
 //  - Utilisation d'une structure infos contenant les informations des mots
 //    lus sur les fichiers. Le mot est contenu dans le tableau fléxible strfl
-//    si le champ str est égale à NULL. Le mot est pointé par str sinon.
+//    et repéré par la portion de chaine key, qui sert de clé de recherche. Ses
+//    huit premiers octets sont aussi mémorisés sous forme d'entier par tag, ce
+//    qui permet à l'arbre avl de départager la plupart des mots sans memcmp.
+//    Les tables de hachage ne comparent par memcmp que des mots de même
+//    longueur et de même valeur de pré-hachage.
+//  - Les mots sont recherchés directement dans les blocs lus sur les fichiers
+//    sous forme de portions de chaines : un mot n'est copié que lors de la
+//    création de sa structure infos.
 //  Résultats:
 //  - Les résultats sont affichés en colonnes sur la sortie standard. Les
 //    colonnes sont séparées par le caractère de tabulation horizontale.
@@ -28,16 +35,26 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <stdalign.h>
 #include <ctype.h>
 #include <locale.h>
 #include "hashtable.h"
+#include "ohashtable.h"
 #include "holdall.h"
 #include "bst.h"
+#include "btree.h"
+#include "art.h"
+#include "rsort.h"
 #include "word.h"
 #include "opt.h"
+#include "input.h"
+#include "scan.h"
+#include "arena.h"
+#include "hash.h"
 
 #define EXEC "xwc"
-#define WRNG_MSG EXEC ": Word from file '%s' cut: '%s...'.\n"
+#define WRNG_MSG EXEC ": Word from file '%s' cut: '%.*s...'.\n"
 #define START_READ "--- starts reading for "
 #define R_FILE_MSG "restrict FILE"
 #define PRINT_NUMF "#%ld FILE"
@@ -87,9 +104,9 @@
     fprintf(stderr, "%s" HELP_ERROR, msg);                                     \
 }
 
-#define CUT_WARNING(cutword, filename) {                                       \
+#define CUT_WARNING(cutspan, filename) {                                       \
     fprintf(stderr, WRNG_MSG, filename,                                        \
-    cutword);                                                                  \
+    (int) (cutspan).length, (cutspan).str);                                    \
 }
 
 #define ON_FILE_ERROR_GOTO(msg, file, s1, label) {                             \
@@ -111,21 +128,43 @@
 #define APPEAR_MULT -1
 #define APPEAR_R_FILE 0
 
+//  Estimation du nombre de mots distincts à partir de la taille des fichiers,
+//    selon la loi de Heaps : pour n mots lus, de l'ordre de
+//    « XWC_HEAPS_K * racine carrée de n » mots distincts, sans dépasser n ni
+//    XWC_EXPECTED_MAX. Le nombre de mots lus est estimé à un mot pour
+//    XWC_BYTES_PER_WORD octets. Surestimer le nombre de mots distincts
+//    disperse les accès dans un tableau de hachage inutilement grand.
+#define XWC_BYTES_PER_WORD 6
+#define XWC_HEAPS_K 32
+#define XWC_EXPECTED_MAX ((size_t) 1 << 22)
+
+//  XWC_BATCH : nombre maximal de mots recherchés ensemble dans la table de
+//    hachage par chainage séparé.
+#define XWC_BATCH 16
+
 typedef struct {
   long int cptr;
   long int fnum;
-  char *str;
+  uint64_t tag;
+  span key;
   char strfl[];
 } infos;
 
 typedef union {
   bst *bt;
   hashtable *ht;
+  ohashtable *oht;
+  btree *bpt;
+  art *at;
 } type_process;
 
-//  str_hashfun : l'une des fonctions de pré-hachage conseillées par Kernighan
-//    et Pike pour les chaines de caractères.
-static size_t str_hashfun(const char *s);
+//  span_hashseed : graine de span_hashfun, tirée au début de chaque exécution.
+static uint64_t span_hashseed;
+
+//  span_hashfun : fonction de pré-hachage des portions de chaines : renvoie la
+//    valeur de hachage par hash_bytes de la portion de chaine associée à sp
+//    pour la graine span_hashseed.
+static size_t span_hashfun(const span *sp);
 
 //  scptr_display : affiche sur la sortie standard le champ str de info, fnum
 //    tabulations et le champ cptr suivi de la fin de ligne selon si le
@@ -133,6 +172,10 @@ static size_t str_hashfun(const char *s);
 //    succès, une valeur non nulle en cas d'échec.
 static int scptr_display(infos *info);
 
+//  scptr_display_context : appelle scptr_display avec ref en ignorant
+//    context, pour un parcours de l'arbre avl.
+static int scptr_display_context(void *context, const void *ref);
+
 //  comp1: Renvoie une fonction de tri sur les deux champs str de s1 et s2.
 //    (tri lexicographique).
 int comp1(const infos *s1, const infos *s2);
@@ -149,21 +192,86 @@ int r_comp1(const infos *s1, const infos *s2);
 //    s1 et s2. (tri décroissant numérique).
 int r_comp2(const infos *s1, const infos *s2);
 
-//  bst_comp: Renvoie une fonction de comparaison pour les arbres avl
+//  bst_comp: Renvoie une fonction de comparaison pour les arbres avl. Les
+//    champs tag de s1 et s2 sont d'abord comparés ; leurs champs key ne le
+//    sont par memcmp que si leurs champs tag sont égaux et que l'un des deux
+//    mots est de longueur strictement supérieure à 8.
 int bst_comp(const infos *s1, const infos *s2);
 
-//  rfree : libère la zone mémoire pointée par ptr et renvoie zéro.
-int rfree(infos *ptr);
+//  span_tag : renvoie l'entier dont les octets, du poids fort au poids faible,
+//    sont les 8 premiers octets de la portion de chaine associée à sp,
+//    complétés si besoin par des zéros. Si les entiers associés à deux
+//    portions diffèrent, leur ordre est celui des portions selon span_compar.
+static uint64_t span_tag(const span *sp);
+
+//  key_differ : fonction de comparaison des clés pour les tables de hachage.
+//    Renvoie zéro si les portions de chaines associées à sp1 et sp2 sont
+//    égales, une valeur non nulle sinon. Les octets ne sont comparés par memcmp
+//    que si les longueurs sont égales.
+static int key_differ(const span *sp1, const span *sp2);
+
+#if defined XWC_STATS && XWC_STATS != 0
+
+//  xwc_ncompar, xwc_nshortcut : nombre d'appels à bst_comp et key_differ et
+//    nombre de ces appels conclus sans memcmp.
+static size_t xwc_ncompar;
+static size_t xwc_nshortcut;
+
+#define XWC_COUNT(counter) (++(counter))
+
+#else
+#define XWC_COUNT(counter)
+#endif
+
+//  xwc_expected : renvoie le nombre de mots distincts attendus selon l'option
+//    correspondante de opt, sans dépasser XWC_EXPECTED_MAX. Si elle est nulle,
+//    ce nombre est estimé à partir de la taille des fichiers dont les mots
+//    peuvent être ajoutés : le fichier restricteur file_tab[0] si l'option
+//    restrict est donnée, les nb_file fichiers suivants de file_tab sinon.
+//    Ce nombre n'est qu'une indication : si la réservation de la table de
+//    hachage échoue, la table reste utilisable et s'agrandit au besoin.
+static size_t xwc_expected(options *opt, const char **file_tab,
+    long int nb_file);
+
+//  xwc_isqrt : renvoie la partie entière de la racine carrée de n.
+static size_t xwc_isqrt(size_t n);
+
+//  xwc_bytewise_collation : indique si la catégorie de locale de nom lc ordonne
+//    les chaines comme strcmp, ce qui est le cas des locales « C » et
+//    « POSIX ». Les mots peuvent alors être affichés dans l'ordre
+//    lexicographique sans être triés, en parcourant dans l'ordre l'arbre avl,
+//    le B+arbre ou l'arbre radix adaptatif.
+static bool xwc_bytewise_collation(const char *lc);
+
+#if defined HOLDALL_WANT_EXT && HOLDALL_WANT_EXT != 0
+
+//  xwc_radix_sort : tente de trier par base les références des informations
+//    du fourretout ha dont le champ fnum est strictement positif, les seules
+//    à être affichées. Si sort est strictement positif, l'ordre est celui des
+//    mots ; sinon, c'est celui des compteurs, les mots de même compteur étant
+//    dans l'ordre des mots. L'ordre des mots ou des compteurs est décroissant
+//    si reversed vaut true. Les mots sont ordonnés selon strcmp si bytewise
+//    vaut true, selon strcoll sinon. Renvoie NULL en cas de dépassement de
+//    capacité. Renvoie sinon l'adresse d'un tableau alloué dynamiquement qui
+//    contient les références triées suivies de NULL.
+static void **xwc_radix_sort(holdall *ha, int sort, bool reversed,
+    bool bytewise);
+
+#endif
+
 
 //  xwc_process: Pour chaque mot lu dans le fichier de nom file et de numéro
 //    numf stocké dans w et traité selon les options définies dans opt, tente
 //    de le rajouter avec ses informations à la structure de donnée associée
 //    à tp et au holdall ha dans le cas où ce mot n'apparait pas dans cette
-//    structure. Sinon si il apparait avec un numéro de fichier différent,
-//    lui associe un numéro de fichier négatif. Incrémente son compteur sinon.
-//    Renvoie zéro en cas de traitement réussi, une valeur non nulle sinon.
+//    structure, ses informations étant allouées dans l'arène ar. Sinon si il
+//    apparait avec un numéro de fichier différent, lui associe un numéro de
+//    fichier négatif. Incrémente son compteur sinon.
+//    Les limites des mots sont recherchées à l'aide de sc. Les mots à cheval
+//    sur deux blocs lus sont rassemblés dans w. Renvoie zéro en cas de
+//    traitement réussi, une valeur non nulle sinon.
 int xwc_process(const char *file, long int numf, type_process *tp, holdall *ha,
-    options *opt, word *w);
+    arena *ar, options *opt, const scan *sc, word *w);
 
 int main(int argc, char *argv[]) {
   int r = EXIT_SUCCESS;
@@ -205,18 +313,38 @@ int main(int argc, char *argv[]) {
     file_tab[nb_file + 1] = STDIN_FILE;
     ++nb_file;
   }
+  span_hashseed = hash_seed();
   type_process tp;
   word *w = word_init();
-  if (opt_get_word_process(opt)) {
-    tp.ht = hashtable_empty((int (*)(const void *, const void *))strcmp,
-        (size_t (*)(const void *))str_hashfun);
-  } else {
-    tp.bt = bst_empty((int (*)(const void *, const void *))bst_comp);
+  scan *sc = scan_init(opt_get_delim_table(opt));
+  switch (opt_get_word_process(opt)) {
+    case WPROCESS_HT:
+      tp.ht = hashtable_empty((int (*)(const void *, const void *))key_differ,
+          (size_t (*)(const void *))span_hashfun);
+      break;
+    case WPROCESS_OHT:
+      tp.oht = ohashtable_empty(
+          (int (*)(const void *, const void *))key_differ,
+          (size_t (*)(const void *))span_hashfun);
+      break;
+    case WPROCESS_BTREE:
+      tp.bpt = btree_empty();
+      break;
+    case WPROCESS_ART:
+      tp.at = art_empty();
+      break;
+    default:
+      tp.bt = bst_empty((int (*)(const void *, const void *))bst_comp);
+      break;
   }
   holdall *ha = holdall_empty();
-  if ((tp.bt == NULL && tp.ht == NULL)
+  arena *ar = arena_empty();
+  if ((tp.bt == NULL && tp.ht == NULL && tp.oht == NULL && tp.bpt == NULL
+      && tp.at == NULL)
       || ha == NULL
-      || w == NULL) {
+      || ar == NULL
+      || w == NULL
+      || sc == NULL) {
     goto error_capacity;
   }
   const char *r_file = opt_get_r_file(opt);
@@ -224,11 +352,22 @@ int main(int argc, char *argv[]) {
   if (is_r_file) {
     file_tab[0] = r_file;
   }
+  size_t expected = xwc_expected(opt, file_tab, nb_file);
+  switch (opt_get_word_process(opt)) {
+    case WPROCESS_HT:
+      (void) hashtable_reserve(tp.ht, expected);
+      break;
+    case WPROCESS_OHT:
+      (void) ohashtable_reserve(tp.oht, expected);
+      break;
+    default:
+      break;
+  }
   for (long int k = !is_r_file; k <= nb_file; ++k) {
     if (strcmp(file_tab[k], STDIN_FILE) == 0) {
       PRINT_START_READING(k);
     }
-    if (xwc_process(file_tab[k], k, &tp, ha, opt, w) != 0) {
+    if (xwc_process(file_tab[k], k, &tp, ha, ar, opt, sc, w) != 0) {
       goto error;
     }
   }
@@ -240,10 +379,27 @@ int main(int argc, char *argv[]) {
     printf("%s", file_tab[k]);
   }
   printf("\n");
+#if defined HASHTABLE_STATS && HASHTABLE_STATS != 0
+  if (opt_get_word_process(opt) == WPROCESS_HT) {
+    hashtable_fprint_stats(tp.ht, stderr);
+  }
+#endif
+#if defined XWC_STATS && XWC_STATS != 0
+  fprintf(stderr, "--- Info: Key comparisons\n"
+      "%12s\t%zu\n%12s\t%zu\n%12s\t%lf\n",
+      "n.compar", xwc_ncompar, "n.shortcut", xwc_nshortcut, "shortcut.rate",
+      xwc_ncompar == 0 ? 0.0 : (double) xwc_nshortcut / (double) xwc_ncompar);
+#endif
+  bool in_order = false;
+  void **refs = NULL;
 #if defined HOLDALL_WANT_EXT && HOLDALL_WANT_EXT != 0
   int sort = opt_get_sort(opt);
   if (sort != 0) {
-    setlocale(LC_COLLATE, "");
+    const char *lc = setlocale(LC_COLLATE, "");
+    wprocess wp = opt_get_word_process(opt);
+    in_order = sort > 0
+        && (wp == WPROCESS_AVL || wp == WPROCESS_BTREE || wp == WPROCESS_ART)
+        && xwc_bytewise_collation(lc);
     int (*compar)(const infos *, const infos *);
     bool r_rev_sort = opt_get_reversed(opt);
     if (r_rev_sort) {
@@ -251,10 +407,32 @@ int main(int argc, char *argv[]) {
     } else {
       compar = sort > 0 ? comp1 : comp2;
     }
-    holdall_sort(ha, (int (*)(const void *, const void *))compar);
+    if (!in_order) {
+      refs = xwc_radix_sort(ha, sort, r_rev_sort, xwc_bytewise_collation(lc));
+    }
+    if (!in_order && refs == NULL) {
+      holdall_sort(ha, (int (*)(const void *, const void *))compar);
+    }
   }
 #endif
-  if (holdall_apply(ha, (int (*)(void *))scptr_display) != 0) {
+  int dir = opt_get_reversed(opt) ? 1 : -1;
+  int rd = 0;
+  if (refs != NULL) {
+    for (void **p = refs; *p != NULL && rd == 0; ++p) {
+      rd = scptr_display(*p);
+    }
+    free(refs);
+  } else if (!in_order) {
+    rd = holdall_apply(ha, (int (*)(void *))scptr_display);
+  } else if (opt_get_word_process(opt) == WPROCESS_BTREE) {
+    rd = btree_apply(tp.bpt, dir, (int (*)(void *))scptr_display);
+  } else if (opt_get_word_process(opt) == WPROCESS_ART) {
+    rd = art_apply(tp.at, dir, (int (*)(void *))scptr_display);
+  } else {
+    rd = bst_dft_infix_apply_context(tp.bt, dir, NULL, scptr_display_context,
+        NULL, NULL);
+  }
+  if (rd != 0) {
     fprintf(stderr, WRITE_ERROR);
     goto error;
   }
@@ -267,28 +445,210 @@ error:
   goto dispose;
 dispose:
   word_dispose(&w);
-  if (opt_get_word_process(opt)) {
-    hashtable_dispose(&tp.ht);
-  } else {
-    bst_dispose(&tp.bt);
-  }
-  if (ha != NULL) {
-    holdall_apply(ha, (int (*)(void *))rfree);
+  scan_dispose(&sc);
+  switch (opt_get_word_process(opt)) {
+    case WPROCESS_HT:
+      hashtable_dispose(&tp.ht);
+      break;
+    case WPROCESS_OHT:
+      ohashtable_dispose(&tp.oht);
+      break;
+    case WPROCESS_BTREE:
+      btree_dispose(&tp.bpt);
+      break;
+    case WPROCESS_ART:
+      art_dispose(&tp.at);
+      break;
+    default:
+      bst_dispose(&tp.bt);
+      break;
   }
   holdall_dispose(&ha);
+  arena_dispose(&ar);
 dispose_opt:
   options_dispose(&opt);
   return r;
 }
 
-size_t str_hashfun(const char *s) {
-  size_t h = 0;
-  for (const unsigned char *p = (const unsigned char *) s; *p != '\0'; ++p) {
-    h = 37 * h + *p;
+size_t span_hashfun(const span *sp) {
+  return (size_t) hash_bytes(sp->str, sp->length, span_hashseed);
+}
+
+size_t xwc_expected(options *opt, const char **file_tab, long int nb_file) {
+  long int e = opt_get_expected(opt);
+  if (e > 0) {
+    return (size_t) e < XWC_EXPECTED_MAX ? (size_t) e : XWC_EXPECTED_MAX;
+  }
+  size_t n = 0;
+  bool is_r_file = opt_get_r_file(opt) != NULL;
+  long int kmax = is_r_file ? 0 : nb_file;
+  for (long int k = !is_r_file; k <= kmax; ++k) {
+    if (strcmp(file_tab[k], STDIN_FILE) != 0) {
+      n += input_filesize(file_tab[k]) / XWC_BYTES_PER_WORD;
+    }
+  }
+  size_t r = xwc_isqrt(n) * XWC_HEAPS_K;
+  r = r < n ? r : n;
+  return r < XWC_EXPECTED_MAX ? r : XWC_EXPECTED_MAX;
+}
+
+size_t xwc_isqrt(size_t n) {
+  if (n < 2) {
+    return n;
+  }
+  size_t r = n;
+  size_t q = n / 2 + n % 2;
+  while (q < r) {
+    r = q;
+    q = (r + n / r) / 2;
+  }
+  return r;
+}
+
+bool xwc_bytewise_collation(const char *lc) {
+  return lc != NULL && (strcmp(lc, "C") == 0 || strcmp(lc, "POSIX") == 0);
+}
+
+#if defined HOLDALL_WANT_EXT && HOLDALL_WANT_EXT != 0
+
+//  struct xwc_collector, xwc_collector : tableau de références en cours de
+//    remplissage, n étant le nombre de références déjà mémorisées.
+typedef struct {
+  void **refs;
+  size_t n;
+} xwc_collector;
+
+//  xwc_collect : ajoute ref au tableau associé à cl si le champ fnum de
+//    l'information repérée par ref est strictement positif. Renvoie NULL.
+static void *xwc_collect(xwc_collector *cl, infos *ref) {
+  if (ref->fnum > 0) {
+    cl->refs[cl->n] = ref;
+    cl->n += 1;
+  }
+  return NULL;
+}
+
+//  xwc_collected : renvoie zéro.
+static int xwc_collected(void *ref, void *resultfun1) {
+  (void) ref;
+  (void) resultfun1;
+  return 0;
+}
+
+//  infos_count, infos_word : renvoient les clés du tri par base des
+//    informations repérées par inf : leur compteur et leur mot.
+static unsigned long infos_count(const infos *inf) {
+  return (unsigned long) inf->cptr;
+}
+
+static const char *infos_word(const infos *inf) {
+  return inf->strfl;
+}
+
+//  struct xwc_xfrm, xwc_xfrm : information accompagnée de la clé de collation
+//    de son mot, telle que calculée par strxfrm. L'ordre des clés selon strcmp
+//    est celui des mots selon strcoll.
+typedef struct {
+  infos *inf;
+  char key[];
+} xwc_xfrm;
+
+//  xfrm_count, xfrm_key : renvoient les clés du tri par base des informations
+//    accompagnées de clés de collation repérées par xf : le compteur et la
+//    clé de collation.
+static unsigned long xfrm_count(const xwc_xfrm *xf) {
+  return (unsigned long) xf->inf->cptr;
+}
+
+static const char *xfrm_key(const xwc_xfrm *xf) {
+  return xf->key;
+}
+
+//  xwc_xfrm_keys : tente de remplacer chacune des n références d'informations
+//    du tableau pointé par refs par la référence de cette information
+//    accompagnée de la clé de collation de son mot, allouée dans l'arène ar.
+//    Renvoie une valeur non nulle en cas de dépassement de capacité. Renvoie
+//    sinon zéro.
+static int xwc_xfrm_keys(void **refs, size_t n, arena *ar) {
+  size_t cap = 0;
+  char *buf = NULL;
+  for (size_t k = 0; k < n; ++k) {
+    infos *inf = refs[k];
+    size_t len = strxfrm(buf, inf->strfl, cap);
+    if (len >= cap) {
+      free(buf);
+      cap = 2 * len + 1;
+      buf = malloc(cap);
+      if (buf == NULL) {
+        return -1;
+      }
+      strxfrm(buf, inf->strfl, cap);
+    }
+    xwc_xfrm *xf = arena_alloc(ar, sizeof *xf + len + 1, alignof(xwc_xfrm));
+    if (xf == NULL) {
+      free(buf);
+      return -1;
+    }
+    xf->inf = inf;
+    memcpy(xf->key, buf, len + 1);
+    refs[k] = xf;
   }
-  return h;
+  free(buf);
+  return 0;
 }
 
+//  Hors des locales « C » et « POSIX », la clé de collation de chaque mot est
+//    calculée une fois par strxfrm, puis les références sont triées selon ces
+//    clés : strcoll, qui recalcule les poids de collation à chaque appel,
+//    n'est plus appelée. Les clés sont libérées avec leur arène après le tri.
+
+void **xwc_radix_sort(holdall *ha, int sort, bool reversed, bool bytewise) {
+  size_t n = holdall_count(ha);
+  if (n >= SIZE_MAX / sizeof(void *)) {
+    return NULL;
+  }
+  xwc_collector cl = {
+    malloc((n + 1) * sizeof(void *)), 0
+  };
+  if (cl.refs == NULL) {
+    return NULL;
+  }
+  holdall_apply_context(ha, &cl, (void *(*)(void *, void *))xwc_collect,
+      xwc_collected);
+  cl.refs[cl.n] = NULL;
+  int dir = reversed ? 1 : -1;
+  if (bytewise) {
+    if (rsort_str(cl.refs, cl.n, sort > 0 ? dir : -1,
+        (const char *(*)(const void *))infos_word) != 0
+        || (sort < 0
+        && rsort_ulong(cl.refs, cl.n, dir,
+        (unsigned long (*)(const void *))infos_count) != 0)) {
+      free(cl.refs);
+      return NULL;
+    }
+    return cl.refs;
+  }
+  arena *ar = arena_empty();
+  if (ar == NULL
+      || xwc_xfrm_keys(cl.refs, cl.n, ar) != 0
+      || rsort_str(cl.refs, cl.n, sort > 0 ? dir : -1,
+      (const char *(*)(const void *))xfrm_key) != 0
+      || (sort < 0
+      && rsort_ulong(cl.refs, cl.n, dir,
+      (unsigned long (*)(const void *))xfrm_count) != 0)) {
+    arena_dispose(&ar);
+    free(cl.refs);
+    return NULL;
+  }
+  for (size_t k = 0; k < cl.n; ++k) {
+    cl.refs[k] = ((xwc_xfrm *) cl.refs[k])->inf;
+  }
+  arena_dispose(&ar);
+  return cl.refs;
+}
+
+#endif
+
 int scptr_display(infos *si) {
   if (si->fnum > 0) {
     if (printf("%s\t", si->strfl) < 0) {
@@ -306,14 +666,45 @@ int scptr_display(infos *si) {
   return 0;
 }
 
+int scptr_display_context(void *context, const void *ref) {
+  (void) context;
+  return scptr_display((infos *) ref);
+}
+
 int comp1(const infos *s1, const infos *s2) {
   return strcoll(s1->strfl, s2->strfl);
 }
 
 int bst_comp(const infos *s1, const infos *s2) {
-  const char *p1 = s1->str != NULL ? s1->str : s1->strfl;
-  const char *p2 = s2->str != NULL ? s2->str : s2->strfl;
-  return strcmp(p1, p2);
+  XWC_COUNT(xwc_ncompar);
+  if (s1->tag != s2->tag) {
+    XWC_COUNT(xwc_nshortcut);
+    return s1->tag > s2->tag ? 1 : -1;
+  }
+  if (s1->key.length <= sizeof s1->tag && s2->key.length <= sizeof s2->tag) {
+    XWC_COUNT(xwc_nshortcut);
+    return s1->key.length == s2->key.length ? 0
+      : s1->key.length > s2->key.length ? 1 : -1;
+  }
+  return span_compar(&s1->key, &s2->key);
+}
+
+uint64_t span_tag(const span *sp) {
+  uint64_t t = 0;
+  const unsigned char *p = (const unsigned char *) sp->str;
+  for (size_t k = 0; k < sizeof t; ++k) {
+    t = (t << 8) | (k < sp->length ? p[k] : 0);
+  }
+  return t;
+}
+
+int key_differ(const span *sp1, const span *sp2) {
+  XWC_COUNT(xwc_ncompar);
+  if (sp1->length != sp2->length) {
+    XWC_COUNT(xwc_nshortcut);
+    return 1;
+  }
+  return memcmp(sp1->str, sp2->str, sp1->length);
 }
 
 int r_comp1(const infos *s1, const infos *s2) {
@@ -334,117 +725,354 @@ int r_comp2(const infos *s1, const infos *s2) {
   return s1->cptr > s2->cptr ? -1 : 1;
 }
 
-int rfree(infos *ptr) {
-  if (ptr->str != NULL) {
-    free(ptr->str);
+//  xwc_word_apply : met à jour les informations du mot associé à sp, lu dans le
+//    fichier de nom file et de numéro numf, selon les mêmes règles que
+//    xwc_process, inf étant le résultat de sa recherche dans la structure de
+//    donnée associée à tp. Si inf vaut NULL et si le mot peut être ajouté, ses
+//    informations sont allouées dans l'arène ar puis ajoutées au holdall ha et
+//    à la structure de donnée : en tant que valeur du couple d'adresse hte ou
+//    ohte si la structure est une table de hachage, du couple d'adresse bte ou
+//    ate si c'est un B+arbre ou un arbre radix adaptatif, en remplacement de
+//    la référence d'adresse btref sinon, le couple ou la référence étant celui
+//    ou celle que la recherche a ajouté.
+//    is_r_file indique si un fichier restricteur a été donné et wp la
+//    structure de données associée à tp. Renvoie zéro en cas de succès, une
+//    valeur non nulle sinon.
+static int xwc_word_apply(const char *file, long int numf,
+    type_process *tp, holdall *ha, arena *ar, bool is_r_file, wprocess wp,
+    const span *sp, infos *inf, hashtable_entry *hte, ohashtable_entry *ohte,
+    btree_entry *bte, art_entry *ate, const void **btref) {
+  bool may_add = !is_r_file || numf == APPEAR_R_FILE;
+  if (inf == NULL) {
+    if (may_add) {
+      infos *i = arena_alloc(ar, sizeof *i + sp->length + 1,
+          alignof(infos));
+      if (i == NULL) {
+        goto error_added;
+      }
+      i->cptr = 1;
+      i->fnum = numf;
+      memcpy(i->strfl, sp->str, sp->length);
+      i->strfl[sp->length] = '\0';
+      i->key = (span) {
+        .str = i->strfl,
+        .length = sp->length
+      };
+      i->tag = span_tag(&i->key);
+      switch (wp) {
+        case WPROCESS_HT:
+          hte->keyref = &i->key;
+          hte->valref = i;
+          break;
+        case WPROCESS_OHT:
+          ohte->keyref = &i->key;
+          ohte->valref = i;
+          break;
+        case WPROCESS_BTREE:
+          bte->keyref = i->strfl;
+          bte->valref = i;
+          break;
+        case WPROCESS_ART:
+          ate->keyref = i->strfl;
+          ate->valref = i;
+          break;
+        default:
+          *btref = i;
+          break;
+      }
+      if (holdall_put(ha, i) != 0) {
+        ON_FILE_ERROR_GOTO(ALLOC_ERROR, file, NULL, error)
+      }
+    }
+  } else {
+    if (inf->fnum == numf) {
+      ++inf->cptr;
+    } else {
+      if (is_r_file && inf->fnum == APPEAR_R_FILE) {
+        inf->cptr = 1;
+        inf->fnum = numf;
+      } else {
+        inf->fnum = APPEAR_MULT;
+      }
+    }
   }
-  free(ptr);
-  return 0;
+  return SUCCESS_FILE;
+error_added:
+  if (hte != NULL) {
+    hashtable_remove(tp->ht, sp);
+  }
+  if (ohte != NULL) {
+    ohashtable_remove(tp->oht, sp);
+  }
+  if (bte != NULL) {
+    btree_remove(tp->bpt, sp->str, sp->length);
+  }
+  if (ate != NULL) {
+    art_remove(tp->at, sp->str, sp->length);
+  }
+  if (btref != NULL) {
+    bst_remove_climbup_left(tp->bt, *btref);
+  }
+  ERROR_FILE_MSG(ALLOC_ERROR, file);
+error:
+  return ERROR_;
+}
+
+//  xwc_word_process : tente de rajouter le mot associé à sp, lu dans le fichier
+//    de nom file et de numéro numf, à la structure de donnée associée à tp et
+//    au holdall ha, ses informations étant allouées dans l'arène ar, selon les
+//    mêmes règles que xwc_process. is_r_file indique si un fichier restricteur
+//    a été donné et wp la structure de données associée à tp. Si celle-ci est
+//    une table de hachage, h est la valeur de pré-hachage du mot. Renvoie zéro
+//    en cas de succès, une valeur non nulle sinon.
+static int xwc_word_process(const char *file, long int numf,
+    type_process *tp, holdall *ha, arena *ar, bool is_r_file, wprocess wp,
+    const span *sp, size_t h) {
+  bool may_add = !is_r_file || numf == APPEAR_R_FILE;
+  infos *inf = NULL;
+  hashtable_entry *hte = NULL;
+  ohashtable_entry *ohte = NULL;
+  btree_entry *bte = NULL;
+  art_entry *ate = NULL;
+  const void **btref = NULL;
+  infos i_tmp;
+  switch (wp) {
+    case WPROCESS_HT:
+      if (!may_add) {
+        inf = hashtable_search_hashed(tp->ht, sp, h);
+        break;
+      }
+      hte = hashtable_find_or_insert_hashed(tp->ht, sp, h);
+      if (hte == NULL) {
+        ON_FILE_ERROR_GOTO(ALLOC_ERROR, file, NULL, error)
+      }
+      inf = (infos *) hte->valref;
+      break;
+    case WPROCESS_OHT:
+      if (!may_add) {
+        inf = ohashtable_search_hashed(tp->oht, sp, h);
+        break;
+      }
+      ohte = ohashtable_find_or_insert_hashed(tp->oht, sp, h);
+      if (ohte == NULL) {
+        ON_FILE_ERROR_GOTO(ALLOC_ERROR, file, NULL, error)
+      }
+      inf = (infos *) ohte->valref;
+      break;
+    case WPROCESS_BTREE:
+      if (!may_add) {
+        inf = btree_search(tp->bpt, sp->str, sp->length);
+        break;
+      }
+      bte = btree_find_or_insert(tp->bpt, sp->str, sp->length);
+      if (bte == NULL) {
+        ON_FILE_ERROR_GOTO(ALLOC_ERROR, file, NULL, error)
+      }
+      inf = (infos *) bte->valref;
+      break;
+    case WPROCESS_ART:
+      if (!may_add) {
+        inf = art_search(tp->at, sp->str, sp->length);
+        break;
+      }
+      ate = art_find_or_insert(tp->at, sp->str, sp->length);
+      if (ate == NULL) {
+        ON_FILE_ERROR_GOTO(ALLOC_ERROR, file, NULL, error)
+      }
+      inf = (infos *) ate->valref;
+      break;
+    default:
+      i_tmp.tag = span_tag(sp);
+      i_tmp.key = *sp;
+      if (!may_add) {
+        inf = bst_search(tp->bt, &i_tmp);
+        break;
+      }
+      btref = bst_find_or_insert(tp->bt, &i_tmp);
+      if (btref == NULL) {
+        ON_FILE_ERROR_GOTO(ALLOC_ERROR, file, NULL, error)
+      }
+      inf = *btref == &i_tmp ? NULL : (infos *) *btref;
+      break;
+  }
+  return xwc_word_apply(file, numf, tp, ha, ar, is_r_file, wp, sp, inf, hte,
+      ohte, bte, ate, btref);
+error:
+  return ERROR_;
+}
+
+//  xwc_batch_process : traite, comme le ferait xwc_word_process, les nb mots
+//    associés à bsp[0], ..., bsp[nb - 1], de valeurs de pré-hachage bh[0],
+//    ..., bh[nb - 1], dans cet ordre. Si wp désigne la table de hachage par
+//    chainage séparé, les mots y sont recherchés ensemble. Renvoie zéro en cas
+//    de succès, une valeur non nulle sinon.
+static int xwc_batch_process(const char *file, long int numf,
+    type_process *tp, holdall *ha, arena *ar, bool is_r_file, wprocess wp,
+    const span *bsp, const size_t *bh, size_t nb) {
+  if (nb == 0) {
+    return SUCCESS_FILE;
+  }
+  if (wp != WPROCESS_HT) {
+    for (size_t k = 0; k < nb; ++k) {
+      if (xwc_word_process(file, numf, tp, ha, ar, is_r_file, wp, &bsp[k],
+          bh[k]) != 0) {
+        return ERROR_;
+      }
+    }
+    return SUCCESS_FILE;
+  }
+  const void *keyrefs[XWC_BATCH];
+  for (size_t k = 0; k < nb; ++k) {
+    keyrefs[k] = &bsp[k];
+  }
+  if (is_r_file && numf != APPEAR_R_FILE) {
+    void *valrefs[XWC_BATCH];
+    hashtable_search_batch(tp->ht, nb, keyrefs, bh, valrefs);
+    for (size_t k = 0; k < nb; ++k) {
+      if (xwc_word_apply(file, numf, tp, ha, ar, is_r_file, wp, &bsp[k],
+          valrefs[k], NULL, NULL, NULL, NULL, NULL) != 0) {
+        return ERROR_;
+      }
+    }
+    return SUCCESS_FILE;
+  }
+  hashtable_entry *entries[XWC_BATCH];
+  size_t n = hashtable_find_or_insert_batch(tp->ht, nb, keyrefs, bh, entries);
+  for (size_t k = 0; k < n; ++k) {
+    if (xwc_word_apply(file, numf, tp, ha, ar, is_r_file, wp, &bsp[k],
+        (infos *) entries[k]->valref, entries[k], NULL, NULL, NULL, NULL)
+        != 0) {
+      return ERROR_;
+    }
+  }
+  if (n < nb) {
+    ERROR_FILE_MSG(ALLOC_ERROR, file);
+    return ERROR_;
+  }
+  return SUCCESS_FILE;
 }
 
 int xwc_process(const char *file, long int numf, type_process *tp, holdall *ha,
-    options *opt, word *w) {
-  FILE *f;
-  bool is_stdin = false;
+    arena *ar, options *opt, const scan *sc, word *w) {
   int r = SUCCESS_FILE;
   bool is_r_file = opt_get_r_file(opt) == NULL ? false : true;
-  bool test_ht = opt_get_word_process(opt);
-  if (strcmp(file, STDIN_FILE) == 0) {
-    f = stdin;
-    is_stdin = true;
-  } else {
-    f = fopen(file, "rb");
-    if (f == NULL) {
-      ERROR_FILE_MSG(FOPEN_ERROR, file);
-      goto error_file;
-    }
+  wprocess wp = opt_get_word_process(opt);
+  bool is_hashed = wp == WPROCESS_HT || wp == WPROCESS_OHT;
+  bool is_stdin = strcmp(file, STDIN_FILE) == 0;
+  input *in = input_open(is_stdin ? NULL : file);
+  if (in == NULL) {
+    ERROR_FILE_MSG(FOPEN_ERROR, file);
+    return ERROR_;
   }
-  int c;
-  while ((c = fgetc(f)) != EOF) {
-    word_renit(w);
-    long int opt_i = opt_get_ivalue(opt);
-    bool i_default = opt_i == I_VAL_DEFAULT;
-    long int i_cpt = 0;
-    while (c != EOF && !(opt_get_isblank_func(opt))(c)
-        && (i_default || i_cpt < opt_i)) {
-      if (word_add(w, c) == NULL) {
-        goto error_file;
+  long int opt_i = opt_get_ivalue(opt);
+  size_t limit = opt_i == I_VAL_DEFAULT ? SIZE_MAX
+    : opt_i < 0 ? 0 : (size_t) opt_i;
+  bool skip = false;
+  word_renit(w);
+  const char *s;
+  size_t n;
+  int rd;
+  span bsp[XWC_BATCH];
+  size_t bh[XWC_BATCH];
+  size_t nb = 0;
+  while ((rd = input_read(in, &s, &n)) > 0) {
+    const char *e = s + n;
+    while (s < e) {
+      if (skip) {
+        s = scan_delim(sc, s, e);
+        if (s == e) {
+          break;
+        }
+        skip = false;
       }
-      ++i_cpt;
-      c = fgetc(f);
-    }
-    if (!i_default
-        && (c != EOF && !(opt_get_isblank_func(opt))(c))) {
-      CUT_WARNING(word_get(w), file);
-      while ((c = fgetc(f)) != EOF && !(opt_get_isblank_func(opt))(c)) {
+      if (word_is_empty(w)) {
+        s = scan_word(sc, s, e);
+        if (s == e) {
+          break;
+        }
       }
-    }
-    if (!word_is_empty(w)) {
-      char *s1 = word_get(w);
-      infos *inf = NULL;
-      if (test_ht) {
-        inf = hashtable_search(tp->ht, s1);
-      } else {
-        infos i_tmp = {
-          .str = s1
-        };
-        inf = bst_search(tp->bt, &i_tmp);
+      uint64_t h = 0;
+      bool hashed = is_hashed && word_is_empty(w);
+      const char *t = hashed
+        ? scan_delim_hash(sc, s, e, span_hashseed, &h)
+        : scan_delim(sc, s, e);
+      size_t room = limit - word_length(w);
+      if ((size_t) (t - s) > room) {
+        t = s + room;
+        skip = true;
+        hashed = false;
       }
-      if (inf == NULL) {
-        if ((!is_r_file || (is_r_file && numf == APPEAR_R_FILE))) {
-          infos *i = malloc(sizeof *i + word_length(w) + 1);
-          if (i == NULL) {
-            ON_FILE_ERROR_GOTO(ALLOC_ERROR, file, NULL, error_file)
-          }
-          i->cptr = 1;
-          i->fnum = numf;
-          i->str = NULL;
-          memcpy(i->strfl, s1, word_length(w) + 1);
-          if (test_ht) {
-            if (hashtable_add(tp->ht, i->strfl, i) == NULL) {
-              ON_FILE_ERROR_GOTO(ALLOC_ERROR, file, i, error_file)
-            }
-          } else {
-            if (bst_add_endofpath(tp->bt, i) == NULL) {
-              ON_FILE_ERROR_GOTO(ALLOC_ERROR, file, i, error_file)
-            }
-          }
-          if (holdall_put(ha, i) != 0) {
-            ON_FILE_ERROR_GOTO(ALLOC_ERROR, file, i, error_file)
-          }
+      if (t == e && !skip) {
+        if (word_append(w, s, (size_t) (t - s)) == NULL) {
+          goto error_file;
         }
-      } else {
-        if (inf->fnum == numf) {
-          ++inf->cptr;
-        } else {
-          if (is_r_file && inf->fnum == APPEAR_R_FILE) {
-            inf->cptr = 1;
-            inf->fnum = numf;
-          } else {
-            inf->fnum = APPEAR_MULT;
+        break;
+      }
+      span sp = {
+        .str = s,
+        .length = (size_t) (t - s)
+      };
+      if (!word_is_empty(w)) {
+        if (word_append(w, s, (size_t) (t - s)) == NULL) {
+          goto error_file;
+        }
+        sp = word_span(w);
+      }
+      if (skip) {
+        CUT_WARNING(sp, file);
+      }
+      if (!hashed && is_hashed) {
+        h = span_hashfun(&sp);
+      }
+      if (sp.length != 0 && word_is_empty(w)) {
+        bsp[nb] = sp;
+        bh[nb] = (size_t) h;
+        ++nb;
+        if (nb == XWC_BATCH) {
+          if (xwc_batch_process(file, numf, tp, ha, ar, is_r_file, wp, bsp,
+              bh, nb) != 0) {
+            goto error_file;
           }
+          nb = 0;
         }
+      } else if (sp.length != 0) {
+        if (xwc_batch_process(file, numf, tp, ha, ar, is_r_file, wp, bsp, bh,
+            nb) != 0
+            || xwc_word_process(file, numf, tp, ha, ar, is_r_file, wp, &sp,
+            (size_t) h) != 0) {
+          goto error_file;
+        }
+        nb = 0;
       }
+      word_renit(w);
+      s = t;
+    }
+    if (xwc_batch_process(file, numf, tp, ha, ar, is_r_file, wp, bsp, bh,
+        nb) != 0) {
+      goto error_file;
     }
+    nb = 0;
+  }
+  if (rd < 0) {
+    goto error_file;
+  }
+  span sp = word_span(w);
+  if (sp.length != 0
+      && xwc_word_process(file, numf, tp, ha, ar, is_r_file, wp, &sp,
+      is_hashed ? span_hashfun(&sp) : 0) != 0) {
+    goto error_file;
   }
   goto end;
 error_file:
+  ERROR_FILE_MSG(FERROR, file);
   r = ERROR_;
 end:
-  if (f != NULL) {
-    if (!feof(f)) {
-      ERROR_FILE_MSG(FERROR, file);
-      r = ERROR_;
-    }
-    if (!is_stdin) {
-      if (fclose(f) != 0) {
-        ERROR_FILE_MSG(FCLOSE_ERROR, file);
-        r = ERROR_;
-      }
-    } else {
-      PRINT_ENDS_READING(numf);
-      rewind(stdin);
-    }
+  if (input_close(&in) != 0) {
+    ERROR_FILE_MSG(FCLOSE_ERROR, file);
+    r = ERROR_;
+  }
+  if (is_stdin) {
+    PRINT_ENDS_READING(numf);
   }
   return r;
 }
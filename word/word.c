@@ -50,6 +50,28 @@ void *word_add(word *w, int c) {
   return w;
 }
 
+void *word_append(word *w, const char *s, size_t n) {
+  if (w->capacity - w->length <= n) {
+    size_t c = w->capacity;
+    while (c - w->length <= n) {
+      if (c > SIZE_MAX / CAPACITY_MULT) {
+        return NULL;
+      }
+      c *= CAPACITY_MULT;
+    }
+    void *a = realloc(w->s, c * sizeof *w->s);
+    if (a == NULL) {
+      return NULL;
+    }
+    w->s = a;
+    w->capacity = c;
+  }
+  memcpy(w->s + w->length, s, n);
+  w->length += n;
+  w->s[w->length] = '\0';
+  return w;
+}
+
 void word_renit(word *w) {
   w->length = 0;
   w->s[0] = '\0';
@@ -67,6 +89,22 @@ size_t word_length(word *w) {
   return w->length;
 }
 
+span word_span(word *w) {
+  return (span) {
+    .str = w->s,
+    .length = w->length
+  };
+}
+
+int span_compar(const span *sp1, const span *sp2) {
+  size_t n = sp1->length < sp2->length ? sp1->length : sp2->length;
+  int c = memcmp(sp1->str, sp2->str, n);
+  if (c != 0) {
+    return c;
+  }
+  return (sp1->length > sp2->length) - (sp1->length < sp2->length);
+}
+
 void word_dispose(word **wptr) {
   if (*wptr != NULL) {
     free((*wptr)->s);
@@ -11,6 +11,17 @@
 //    les informations nécessaires pour gérer un mot de longueur indéfinie.
 typedef struct word word;
 
+//  struct span, span : type et nom de type d'une portion de chaine de
+//    caractères repérée par l'adresse str de son premier caractère et par sa
+//    longueur length. La portion n'est pas nécessairement suivie du caractère
+//    nul.
+typedef struct span span;
+
+struct span {
+  const char *str;
+  size_t length;
+};
+
 //  word_init :  tente d'allouer les ressources nécessaires pour gérer un
 //    nouveau mot initialement vide. Renvoie NULL en cas de dépassement de
 //    capacité. Renvoie sinon un pointeur vers le contrôleur associé au mot.
@@ -21,6 +32,11 @@ extern word *word_init();
 //    aprés l'insertion.
 extern void *word_add(word *w, int c);
 
+//  word_append : tente d'insérer à la fin du mot associé à w les n caractères
+//    rangés à partir de l'adresse s. Renvoie NULL en cas de dépassement de
+//    capacité. Renvoie sinon le nouveau mot obtenu aprés l'insertion.
+extern void *word_append(word *w, const char *s, size_t n);
+
 //  word_renit : met à zero la longueur associée au mot w et le transforme en
 //    mot vide.
 extern void word_renit(word *w);
@@ -35,7 +51,18 @@ extern char *word_get(word *w);
 //  word_length : renvoie la longueur du mot associée à w.
 extern size_t word_length(word *w);
 
-//  stack_dispose : sans effet si *wptr vaut NULL. Libère sinon les ressources
+//  word_span : Renvoie la portion de chaine associée au mot w. Elle reste
+//    valide jusqu'à la prochaine modification de w.
+extern span word_span(word *w);
+
+//  span_compar : compare les portions de chaines associées à sp1 et sp2 selon
+//    l'ordre lexicographique sur les valeurs des octets, une portion étant
+//    inférieure à toute portion dont elle est un préfixe strict. Renvoie une
+//    valeur strictement négative, nulle ou strictement positive selon que la
+//    première est inférieure, égale ou supérieure à la seconde.
+extern int span_compar(const span *sp1, const span *sp2);
+
+//  word_dispose : sans effet si *wptr vaut NULL. Libère sinon les ressources
 //    allouées à la gestion du mot associé à *wptr puis affecte NULL à
 //    *wptr.
 extern void word_dispose(word **wptr);